@@ -4,3 +4,4 @@ set -e
 cmake -GNinja -B build -S . -DCMAKE_POLICY_VERSION_MINIMUM=3.5
 cmake --build build --
 ./build/test/run_tests
+./build/test/stress/run_stress_tests
@@ -4,6 +4,40 @@
 #include "ring_buf.h"
 #include "ring_buf_private.h"
 
+#if defined(__GNUC__)
+#define RING_BUF_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define RING_BUF_PREFETCH(addr) ((void)(addr))
+#endif
+
+/** Number of bytes at the start of the next batch that are prefetched while the drain callback runs. */
+#define RING_BUF_DRAIN_PREFETCH_BYTES 256
+#define RING_BUF_CACHE_LINE_SIZE 64
+
+/**
+ * @brief Check whether field schema in init config is valid.
+ *
+ * @param[in] cfg Init config with field_sizes not NULL.
+ *
+ * @retval true Every field is at least one byte and field sizes add up to elem_size.
+ * @retval false Field schema is invalid.
+ */
+static bool is_valid_field_sizes(const RingBufInitCfg *const cfg)
+{
+    if (cfg->num_fields == 0) {
+        return false;
+    }
+
+    size_t total_size = 0;
+    for (size_t i = 0; i < cfg->num_fields; i++) {
+        if (cfg->field_sizes[i] == 0) {
+            return false;
+        }
+        total_size += cfg->field_sizes[i];
+    }
+    return (total_size == cfg->elem_size);
+}
+
 /**
  * @brief Check whether init config is valid.
  *
@@ -21,6 +55,8 @@ static bool is_valid_cfg(const RingBufInitCfg *const cfg)
         && (cfg->elem_size > 0)
         && (cfg->num_elems > 0)
         && cfg->buffer
+        && (!cfg->get_timestamp || (cfg->timestamps && cfg->latency_hist))
+        && (!cfg->field_sizes || is_valid_field_sizes(cfg))
     );
     // clang-format on
 }
@@ -51,6 +87,228 @@ static bool is_full(RingBuf self)
     return self->full;
 }
 
+/**
+ * @brief Get number of elements stored in ring buffer.
+ *
+ * @param[in] self Ring buffer instance.
+ *
+ * @return size_t Number of stored elements.
+ */
+static size_t get_count(RingBuf self)
+{
+    if (self->full) {
+        return self->num_elems;
+    }
+    return (self->head + self->num_elems - self->tail) % self->num_elems;
+}
+
+/**
+ * @brief Get index of the latency histogram bucket that a value belongs to.
+ *
+ * @param[in] value Value.
+ *
+ * @return size_t Bucket index.
+ */
+static size_t get_latency_bucket(uint64_t value)
+{
+    if (value < RING_BUF_LATENCY_HIST_LINEAR_MAX) {
+        return (size_t)value;
+    }
+
+    size_t msb = 0;
+    for (uint64_t v = value; v > 1; v >>= 1) {
+        msb++;
+    }
+    /* Keep the 3 bits below the most significant bit to select one of 8 sub-buckets */
+    const size_t shift = msb - 3;
+    const size_t sub_bucket = (size_t)(value >> shift) - RING_BUF_LATENCY_HIST_SUB_BUCKETS;
+    return RING_BUF_LATENCY_HIST_LINEAR_MAX + ((msb - 4) * RING_BUF_LATENCY_HIST_SUB_BUCKETS) + sub_bucket;
+}
+
+/**
+ * @brief Get the largest value that belongs to a latency histogram bucket.
+ *
+ * @param[in] bucket Bucket index.
+ *
+ * @return uint64_t Largest value in the bucket.
+ */
+static uint64_t get_latency_bucket_max(size_t bucket)
+{
+    if (bucket < RING_BUF_LATENCY_HIST_LINEAR_MAX) {
+        return (uint64_t)bucket;
+    }
+
+    const size_t idx = bucket - RING_BUF_LATENCY_HIST_LINEAR_MAX;
+    const size_t msb = (idx / RING_BUF_LATENCY_HIST_SUB_BUCKETS) + 4;
+    const uint64_t sub_bucket = (idx % RING_BUF_LATENCY_HIST_SUB_BUCKETS) + RING_BUF_LATENCY_HIST_SUB_BUCKETS;
+    const size_t shift = msb - 3;
+    return (sub_bucket << shift) + (((uint64_t)1 << shift) - 1);
+}
+
+/**
+ * @brief Record how long the elements in the given slots stayed in the ring buffer, if latency tracing is enabled.
+ *
+ * @param[in] self Ring buffer instance.
+ * @param[in] slot Index of the first slot.
+ * @param[in] num_elems Number of consecutive slots, must not wrap around the end of the storage.
+ */
+static void record_latency(RingBuf self, size_t slot, size_t num_elems)
+{
+    if (!self->get_timestamp) {
+        return;
+    }
+
+    const uint64_t now = self->get_timestamp(self->get_timestamp_user_data);
+    RingBufLatencyHist *const hist = self->latency_hist;
+    for (size_t i = slot; i < slot + num_elems; i++) {
+        const uint64_t latency = now - self->timestamps[i];
+        hist->counts[get_latency_bucket(latency)]++;
+        hist->total_count++;
+        if (latency > hist->max) {
+            hist->max = latency;
+        }
+    }
+}
+
+/**
+ * @brief Check whether drain config is valid.
+ *
+ * @param[in] cfg Drain config.
+ *
+ * @retval true Drain config is valid.
+ * @retval false Drain config is invalid.
+ */
+static bool is_valid_drain_cfg(const RingBufDrainCfg *const cfg)
+{
+    return (cfg && (cfg->max_batch > 0) && (cfg->min_batch > 0));
+}
+
+/**
+ * @brief Prefetch the start of a run of elements.
+ *
+ * @param[in] self Ring buffer instance.
+ * @param[in] slot Index of the first element in the run.
+ * @param[in] num_elems Number of elements in the run.
+ */
+static void prefetch_elems(RingBuf self, size_t slot, size_t num_elems)
+{
+    const uint8_t *const start = self->buffer + (slot * self->elem_size);
+    size_t size = num_elems * self->elem_size;
+    if (size > RING_BUF_DRAIN_PREFETCH_BYTES) {
+        size = RING_BUF_DRAIN_PREFETCH_BYTES;
+    }
+    for (size_t offset = 0; offset < size; offset += RING_BUF_CACHE_LINE_SIZE) {
+        RING_BUF_PREFETCH(start + offset);
+    }
+}
+
+/**
+ * @brief Get stored elements as contiguous runs in the ring buffer storage.
+ *
+ * @param[in] self Ring buffer instance.
+ * @param[in] base Start of the storage: the buffer, or a column in struct-of-arrays layout.
+ * @param[in] stride Size of one value in the storage: elem_size, or field size in struct-of-arrays layout.
+ * @param[out] spans Spans are written to this parameter.
+ */
+static void get_spans(RingBuf self, const uint8_t *base, size_t stride, RingBufSpans *const spans)
+{
+    const size_t count = get_count(self);
+    const size_t until_end = self->num_elems - self->tail;
+
+    spans->first_num_elems = (count < until_end) ? count : until_end;
+    spans->second_num_elems = count - spans->first_num_elems;
+    spans->first = (spans->first_num_elems > 0) ? (base + (self->tail * stride)) : NULL;
+    spans->second = (spans->second_num_elems > 0) ? base : NULL;
+}
+
+/**
+ * @brief Copy stored values to the start of another buffer, oldest first.
+ *
+ * @param[in] self Ring buffer instance.
+ * @param[in] base Start of the storage: the buffer, or a column in struct-of-arrays layout.
+ * @param[in] stride Size of one value in the storage: elem_size, or field size in struct-of-arrays layout.
+ * @param[out] dest Buffer to copy the values to.
+ */
+static void copy_linearized(RingBuf self, const uint8_t *base, size_t stride, uint8_t *dest)
+{
+    RingBufSpans spans;
+    get_spans(self, base, stride, &spans);
+    const size_t first_size = spans.first_num_elems * stride;
+    if (spans.first_num_elems > 0) {
+        memcpy(dest, spans.first, first_size);
+    }
+    if (spans.second_num_elems > 0) {
+        memcpy(dest + first_size, spans.second, spans.second_num_elems * stride);
+    }
+}
+
+/**
+ * @brief Get start of a field column in struct-of-arrays layout.
+ *
+ * @param[in] self Ring buffer instance with field schema.
+ * @param[in] buffer Storage buffer.
+ * @param[in] num_elems Capacity of the storage buffer in elements.
+ * @param[in] field_idx Field index.
+ *
+ * @return uint8_t * Pointer to the value of the field in slot 0.
+ */
+static uint8_t *get_column(RingBuf self, uint8_t *buffer, size_t num_elems, size_t field_idx)
+{
+    size_t column_offset = 0;
+    for (size_t i = 0; i < field_idx; i++) {
+        column_offset += RING_BUF_SOA_COLUMN_SIZE(num_elems, self->field_sizes[i]);
+    }
+    return buffer + column_offset;
+}
+
+/**
+ * @brief Copy an element into a slot.
+ *
+ * @param[in] self Ring buffer instance.
+ * @param[in] slot Slot index.
+ * @param[in] element Element to copy.
+ */
+static void write_elem(RingBuf self, size_t slot, const uint8_t *element)
+{
+    if (!self->field_sizes) {
+        memcpy(self->buffer + (slot * self->elem_size), element, self->elem_size);
+        return;
+    }
+
+    /* Scatter fields into their columns */
+    uint8_t *column = self->buffer;
+    for (size_t i = 0; i < self->num_fields; i++) {
+        const size_t field_size = self->field_sizes[i];
+        memcpy(column + (slot * field_size), element, field_size);
+        element += field_size;
+        column += RING_BUF_SOA_COLUMN_SIZE(self->num_elems, field_size);
+    }
+}
+
+/**
+ * @brief Copy an element out of a slot.
+ *
+ * @param[in] self Ring buffer instance.
+ * @param[in] slot Slot index.
+ * @param[out] element Buffer to copy the element into.
+ */
+static void read_elem(RingBuf self, size_t slot, uint8_t *element)
+{
+    if (!self->field_sizes) {
+        memcpy(element, self->buffer + (slot * self->elem_size), self->elem_size);
+        return;
+    }
+
+    /* Gather fields from their columns */
+    const uint8_t *column = self->buffer;
+    for (size_t i = 0; i < self->num_fields; i++) {
+        const size_t field_size = self->field_sizes[i];
+        memcpy(element, column + (slot * field_size), field_size);
+        element += field_size;
+        column += RING_BUF_SOA_COLUMN_SIZE(self->num_elems, field_size);
+    }
+}
+
 uint8_t ring_buf_create(RingBuf *const inst, const RingBufInitCfg *const cfg)
 {
     if (!inst || !is_valid_cfg(cfg)) {
@@ -68,6 +326,16 @@ uint8_t ring_buf_create(RingBuf *const inst, const RingBufInitCfg *const cfg)
     (*inst)->head = 0;
     (*inst)->tail = 0;
     (*inst)->full = false;
+    (*inst)->drain_wait_cnt = 0;
+    (*inst)->field_sizes = cfg->field_sizes;
+    (*inst)->num_fields = cfg->field_sizes ? cfg->num_fields : 0;
+    (*inst)->get_timestamp = cfg->get_timestamp;
+    (*inst)->get_timestamp_user_data = cfg->get_timestamp_user_data;
+    (*inst)->timestamps = cfg->timestamps;
+    (*inst)->latency_hist = cfg->latency_hist;
+    if (cfg->get_timestamp) {
+        memset(cfg->latency_hist, 0, sizeof(RingBufLatencyHist));
+    }
     return RING_BUF_RESULT_CODE_OK;
 }
 
@@ -80,7 +348,10 @@ uint8_t ring_buf_push(RingBuf self, const void *const element)
         return RING_BUF_RESULT_CODE_NO_DATA;
     }
 
-    memcpy(self->buffer + (self->head * self->elem_size), element, self->elem_size);
+    write_elem(self, self->head, (const uint8_t *)element);
+    if (self->get_timestamp) {
+        self->timestamps[self->head] = self->get_timestamp(self->get_timestamp_user_data);
+    }
     self->head = (self->head + 1) % self->num_elems;
     if (self->head == self->tail) {
         self->full = true;
@@ -97,8 +368,209 @@ uint8_t ring_buf_pop(RingBuf self, void *const element)
         return RING_BUF_RESULT_CODE_NO_DATA;
     }
 
-    memcpy(element, self->buffer + (self->tail * self->elem_size), self->elem_size);
+    read_elem(self, self->tail, (uint8_t *)element);
+    record_latency(self, self->tail, 1);
     self->tail = (self->tail + 1) % self->num_elems;
     self->full = false;
     return RING_BUF_RESULT_CODE_OK;
 }
+
+uint8_t ring_buf_get_count(RingBuf self, size_t *const count)
+{
+    if (!self || !count) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    *count = get_count(self);
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_peek(RingBuf self, size_t index, void *const element)
+{
+    if (!self || !element) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+    if (index >= get_count(self)) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+
+    read_elem(self, (self->tail + index) % self->num_elems, (uint8_t *)element);
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_get_spans(RingBuf self, RingBufSpans *const spans)
+{
+    if (!self || !spans || self->field_sizes) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    get_spans(self, self->buffer, self->elem_size, spans);
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_get_column_spans(RingBuf self, size_t field_idx, RingBufSpans *const spans)
+{
+    if (!self || !spans || !self->field_sizes || (field_idx >= self->num_fields)) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    const uint8_t *const column = get_column(self, self->buffer, self->num_elems, field_idx);
+    get_spans(self, column, self->field_sizes[field_idx], spans);
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+/**
+ * @brief Move the ring buffer to a new storage buffer, and the push timestamps to a new timestamps buffer.
+ *
+ * @param[in] self Ring buffer instance.
+ * @param[in] buffer New storage buffer.
+ * @param[in] timestamps New timestamps buffer, NULL if latency tracing is disabled.
+ * @param[in] num_elems New capacity in elements.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully moved the ring buffer to the new buffers.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA @p num_elems is less than the number of currently stored elements.
+ */
+static uint8_t resize(RingBuf self, uint8_t *const buffer, uint64_t *const timestamps, size_t num_elems)
+{
+    const size_t count = get_count(self);
+    if (count > num_elems) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+
+    if (!self->field_sizes) {
+        copy_linearized(self, self->buffer, self->elem_size, buffer);
+    } else {
+        /* Columns start at different offsets in a buffer of different capacity - linearize each one */
+        for (size_t i = 0; i < self->num_fields; i++) {
+            const uint8_t *const old_column = get_column(self, self->buffer, self->num_elems, i);
+            uint8_t *const new_column = get_column(self, buffer, num_elems, i);
+            copy_linearized(self, old_column, self->field_sizes[i], new_column);
+        }
+    }
+    if (timestamps) {
+        /* Timestamps are indexed by slot, so they move along with the elements */
+        copy_linearized(self, (const uint8_t *)self->timestamps, sizeof(uint64_t), (uint8_t *)timestamps);
+        self->timestamps = timestamps;
+    }
+
+    self->buffer = buffer;
+    self->num_elems = num_elems;
+    self->tail = 0;
+    self->head = count % num_elems;
+    self->full = (count == num_elems);
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_resize(RingBuf self, void *const buffer, size_t num_elems)
+{
+    if (!self || !buffer || (num_elems == 0) || self->get_timestamp) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    return resize(self, (uint8_t *)buffer, NULL, num_elems);
+}
+
+uint8_t ring_buf_resize_traced(RingBuf self, void *const buffer, uint64_t *const timestamps, size_t num_elems)
+{
+    if (!self || !buffer || !timestamps || (num_elems == 0) || !self->get_timestamp) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    return resize(self, (uint8_t *)buffer, timestamps, num_elems);
+}
+
+uint8_t ring_buf_drain(RingBuf self, const RingBufDrainCfg *const cfg, RingBufDrainCb cb, void *user_data,
+                       size_t *const num_drained)
+{
+    if (!self || !is_valid_drain_cfg(cfg) || !cb || self->field_sizes) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+    if (num_drained) {
+        *num_drained = 0;
+    }
+
+    size_t remaining = get_count(self);
+    if (remaining == 0) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+    if ((remaining < cfg->min_batch) && (self->drain_wait_cnt < cfg->max_wait)) {
+        self->drain_wait_cnt++;
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+    self->drain_wait_cnt = 0;
+
+    size_t drained = 0;
+    while (remaining > 0) {
+        size_t batch = self->num_elems - self->tail;
+        if (batch > remaining) {
+            batch = remaining;
+        }
+        if (batch > cfg->max_batch) {
+            batch = cfg->max_batch;
+        }
+
+        const size_t next_slot = (self->tail + batch) % self->num_elems;
+        if (remaining > batch) {
+            const size_t next_until_end = self->num_elems - next_slot;
+            const size_t next_remaining = remaining - batch;
+            prefetch_elems(self, next_slot, (next_remaining < next_until_end) ? next_remaining : next_until_end);
+        }
+
+        /* Residency ends when the batch is handed over, time spent in the callback is not counted */
+        record_latency(self, self->tail, batch);
+        cb(self->buffer + (self->tail * self->elem_size), batch, user_data);
+
+        self->tail = next_slot;
+        self->full = false;
+        remaining -= batch;
+        drained += batch;
+    }
+
+    if (num_drained) {
+        *num_drained = drained;
+    }
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_get_latency_hist(RingBuf self, RingBufLatencyHist *const hist)
+{
+    if (!self || !hist) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+    if (!self->get_timestamp) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+
+    memcpy(hist, self->latency_hist, sizeof(RingBufLatencyHist));
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_latency_hist_get_percentile(const RingBufLatencyHist *const hist, uint32_t permille,
+                                             uint64_t *const value)
+{
+    if (!hist || !value || (permille > 1000)) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+    if (hist->total_count == 0) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+
+    /* Number of values that are <= the requested percentile, rounded up. At least 1, so that p0 is the minimum. */
+    uint64_t target = ((hist->total_count * permille) + 999) / 1000;
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    size_t bucket = 0;
+    for (; bucket < RING_BUF_LATENCY_HIST_NUM_BUCKETS - 1; bucket++) {
+        seen += hist->counts[bucket];
+        if (seen >= target) {
+            break;
+        }
+    }
+
+    const uint64_t bucket_max = get_latency_bucket_max(bucket);
+    *value = (bucket_max < hist->max) ? bucket_max : hist->max;
+    return RING_BUF_RESULT_CODE_OK;
+}
@@ -7,6 +7,7 @@ extern "C"
 #endif
 
 #include <stdint.h>
+#include <stddef.h>
 
 typedef struct RingBufStruct *RingBuf;
 
@@ -43,6 +44,48 @@ typedef struct RingBufStruct *RingBuf;
  */
 typedef void *(*RingBufGetInstBuf)(void *user_data);
 
+/**
+ * @brief Gets called on every push and pop to get the current time, if latency tracing is enabled.
+ *
+ * Should be cheap, e.g. read a cycle counter or a free-running hardware timer, or call
+ * clock_gettime(CLOCK_MONOTONIC). The returned value must be monotonic. Units are up to the application, and the
+ * latency histogram is recorded in the same units.
+ *
+ * @param user_data When this function is called, this parameter will be equal to the get_timestamp_user_data field
+ * in the RingBufInitCfg passed to @ref ring_buf_create.
+ *
+ * @return uint64_t Current timestamp.
+ */
+typedef uint64_t (*RingBufGetTimestamp)(void *user_data);
+
+/** Alignment of every column start, relative to the buffer start, in struct-of-arrays layout. */
+#define RING_BUF_SOA_COLUMN_ALIGN 64
+/** Size of a column in struct-of-arrays layout, including the padding up to the start of the next column. */
+#define RING_BUF_SOA_COLUMN_SIZE(num_elems, field_size)                                                                \
+    ((((num_elems) * (field_size)) + RING_BUF_SOA_COLUMN_ALIGN - 1) & ~((size_t)RING_BUF_SOA_COLUMN_ALIGN - 1))
+
+/** Values below this are recorded exactly in the latency histogram, each in its own bucket. */
+#define RING_BUF_LATENCY_HIST_LINEAR_MAX 16
+/** Number of buckets that every power of two above RING_BUF_LATENCY_HIST_LINEAR_MAX is split into. */
+#define RING_BUF_LATENCY_HIST_SUB_BUCKETS 8
+/** Total number of buckets, enough to cover the whole uint64_t range. */
+#define RING_BUF_LATENCY_HIST_NUM_BUCKETS (RING_BUF_LATENCY_HIST_LINEAR_MAX + (60 * RING_BUF_LATENCY_HIST_SUB_BUCKETS))
+
+/**
+ * Log-linear histogram of how long elements stayed in a ring buffer between push and pop.
+ *
+ * Every power of two is split into RING_BUF_LATENCY_HIST_SUB_BUCKETS equal buckets, so a recorded value is off by at
+ * most 1/8 (12.5%) of itself.
+ */
+typedef struct {
+    /** Number of recorded values in each bucket. */
+    uint64_t counts[RING_BUF_LATENCY_HIST_NUM_BUCKETS];
+    /** Total number of recorded values. */
+    uint64_t total_count;
+    /** Largest recorded value. */
+    uint64_t max;
+} RingBufLatencyHist;
+
 typedef struct {
     /** Function to get memory buffer for the instance. See @ref RingBufGetInstBuf. Cannot be NULL. */
     RingBufGetInstBuf get_inst_buf;
@@ -52,8 +95,29 @@ typedef struct {
     size_t elem_size;
     /** Maximum number of elements that can be in the buffer at the same time. Must be > 0. */
     size_t num_elems;
-    /** Buffer to store the elements, must be of size (num_elems * elem_size). Cannot be NULL. */
+    /** Buffer to store the elements, must be of size (num_elems * elem_size). In struct-of-arrays layout, must be of
+     * size equal to the sum of @ref RING_BUF_SOA_COLUMN_SIZE(num_elems, field_size) over all fields instead, and
+     * should be aligned to RING_BUF_SOA_COLUMN_ALIGN so that every column is aligned. Cannot be NULL. */
     void *buffer;
+    /** Function to get the current time for latency tracing. See @ref RingBufGetTimestamp. NULL disables latency
+     * tracing, then the timestamps and latency_hist fields are ignored. */
+    RingBufGetTimestamp get_timestamp;
+    /** User data argument to pass to the get_timestamp function. */
+    void *get_timestamp_user_data;
+    /** Buffer to store the push timestamp of every element, must be of size num_elems. Cannot be NULL if
+     * get_timestamp is not NULL. */
+    uint64_t *timestamps;
+    /** Histogram to record element residency times into. Cleared in @ref ring_buf_create. Cannot be NULL if
+     * get_timestamp is not NULL. */
+    RingBufLatencyHist *latency_hist;
+    /** Size in bytes of every field of an element, in the order the fields appear in the element. If not NULL, the
+     * buffer uses struct-of-arrays layout: each field is stored in its own column of num_elems values, and columns
+     * follow each other in the buffer, each starting at a multiple of RING_BUF_SOA_COLUMN_ALIGN. Field sizes must be
+     * > 0 and add up to elem_size. The array must remain valid as long as the instance is used. NULL selects the
+     * default array-of-structs layout, one element after another. */
+    const size_t *field_sizes;
+    /** Number of fields in field_sizes. Must be > 0 if field_sizes is not NULL. */
+    size_t num_fields;
 } RingBufInitCfg;
 
 typedef enum {
@@ -62,6 +126,54 @@ typedef enum {
     RING_BUF_RESULT_CODE_NO_DATA,
 } RingBufResultCode;
 
+/**
+ * @brief Elements currently stored in a ring buffer, as at most two contiguous runs in the ring buffer's storage.
+ *
+ * Elements in first are older than elements in second. second is only used when the stored elements wrap around the
+ * end of the storage.
+ */
+typedef struct {
+    /** Pointer to the oldest element. NULL if first_num_elems is 0. */
+    const void *first;
+    /** Number of elements in first. */
+    size_t first_num_elems;
+    /** Pointer to the element at the start of the storage that follows the last element in first. NULL if
+     * second_num_elems is 0. */
+    const void *second;
+    /** Number of elements in second. */
+    size_t second_num_elems;
+} RingBufSpans;
+
+/**
+ * @brief Gets called by @ref ring_buf_drain with a run of contiguous elements taken from the ring buffer's storage.
+ *
+ * The elements are removed from the ring buffer after this function returns, so they must be processed or copied
+ * before returning. This function must not call @ref ring_buf_pop, @ref ring_buf_drain or @ref ring_buf_resize on
+ * the instance that is being drained.
+ *
+ * @param elems Pointer to the oldest element in the run.
+ * @param num_elems Number of elements in the run, between 1 and RingBufDrainCfg::max_batch.
+ * @param user_data User data argument passed to @ref ring_buf_drain.
+ */
+typedef void (*RingBufDrainCb)(const void *elems, size_t num_elems, void *user_data);
+
+/**
+ * Drain thresholds that trade off latency against throughput.
+ *
+ * Low latency: min_batch = 1, small max_batch - elements are handed to the consumer as soon as they are available.
+ * High throughput: large min_batch and max_batch - the consumer gets fewer, larger batches. max_wait bounds how many
+ * drain calls elements can be held back while waiting for a full batch.
+ */
+typedef struct {
+    /** Maximum number of elements passed to one callback invocation. Must be > 0. */
+    size_t max_batch;
+    /** Minimum number of stored elements for draining to start. Must be > 0. */
+    size_t min_batch;
+    /** Maximum number of consecutive @ref ring_buf_drain calls that return without draining because fewer than
+     * min_batch elements are stored. The next call after that drains whatever is stored. 0 means never hold back. */
+    size_t max_wait;
+} RingBufDrainCfg;
+
 /**
  * @brief Create a ring buffer instance.
  *
@@ -100,6 +212,159 @@ uint8_t ring_buf_push(RingBuf self, const void *const element);
  */
 uint8_t ring_buf_pop(RingBuf self, void *const element);
 
+/**
+ * @brief Get the number of elements currently stored in the ring buffer.
+ *
+ * @param[in] self Ring buffer instance created by @ref ring_buf_create.
+ * @param[out] count Number of stored elements is written to this parameter.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully got the number of elements.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL or @p count is NULL.
+ */
+uint8_t ring_buf_get_count(RingBuf self, size_t *const count);
+
+/**
+ * @brief Copy an element from the ring buffer without removing it.
+ *
+ * @param[in] self Ring buffer instance created by @ref ring_buf_create.
+ * @param[in] index Index of the element to copy. 0 is the oldest element, i.e. the one that @ref ring_buf_pop would
+ * return next.
+ * @param[out] element Buffer to write the element into. Must point to a buffer of size "elem_size" bytes that was
+ * passed to the init cfg.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully copied the element.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA @p index is not less than the number of stored elements.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL or @p element is NULL.
+ */
+uint8_t ring_buf_peek(RingBuf self, size_t index, void *const element);
+
+/**
+ * @brief Get the stored elements as contiguous runs in the ring buffer's storage, without removing them.
+ *
+ * This allows to iterate over all stored elements in place, from oldest to newest. The returned pointers remain valid
+ * until the next @ref ring_buf_pop, @ref ring_buf_drain or @ref ring_buf_resize call. @ref ring_buf_push does not
+ * modify the elements that the spans point to.
+ *
+ * @param[in] self Ring buffer instance created by @ref ring_buf_create.
+ * @param[out] spans Spans are written to this parameter.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully got the spans.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL, @p spans is NULL, or @p self uses struct-of-arrays layout -
+ * use @ref ring_buf_get_column_spans instead.
+ */
+uint8_t ring_buf_get_spans(RingBuf self, RingBufSpans *const spans);
+
+/**
+ * @brief Get the values of one field of the stored elements as contiguous runs in a column, without removing them.
+ *
+ * Only for instances that use struct-of-arrays layout, i.e. were created with field_sizes in the init cfg. Span
+ * pointers point to values of the field, and span lengths are in values, so a scan over one field of all stored
+ * elements reads only that field's memory. The returned pointers remain valid until the next @ref ring_buf_pop or
+ * @ref ring_buf_resize call.
+ *
+ * @param[in] self Ring buffer instance created by @ref ring_buf_create.
+ * @param[in] field_idx Index of the field in the field_sizes array passed to the init cfg.
+ * @param[out] spans Spans are written to this parameter.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully got the spans.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL, @p spans is NULL, @p self does not use struct-of-arrays
+ * layout, or @p field_idx is out of range.
+ */
+uint8_t ring_buf_get_column_spans(RingBuf self, size_t field_idx, RingBufSpans *const spans);
+
+/**
+ * @brief Move the ring buffer to a new storage buffer with a different capacity, keeping all stored elements.
+ *
+ * Stored elements are copied to the start of the new buffer in order, oldest first, with at most two memcpy calls -
+ * or at most two per field in struct-of-arrays layout, one column at a time.
+ * After this function returns successfully, the ring buffer no longer uses the old buffer, and the caller can reuse
+ * or free it.
+ *
+ * @param[in] self Ring buffer instance created by @ref ring_buf_create.
+ * @param[in] buffer New buffer to store the elements, same size requirements as RingBufInitCfg::buffer for the new
+ * num_elems. Must not overlap with the current buffer. Cannot be NULL.
+ * @param[in] num_elems New maximum number of elements that can be in the buffer at the same time. Must be > 0.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully moved the ring buffer to the new buffer.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA @p num_elems is less than the number of currently stored elements. The ring
+ * buffer is left unchanged.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL, @p buffer is NULL, @p num_elems is 0, or latency tracing
+ * is enabled for @p self - use @ref ring_buf_resize_traced instead.
+ */
+uint8_t ring_buf_resize(RingBuf self, void *const buffer, size_t num_elems);
+
+/**
+ * @brief Same as @ref ring_buf_resize, for instances with latency tracing enabled.
+ *
+ * The push timestamps of the stored elements are moved to @p timestamps in the same order as the elements, so
+ * residency times of elements that were stored before the resize are still recorded correctly. After this function
+ * returns successfully, the caller can also reuse or free the old timestamps buffer.
+ *
+ * @param[in] self Ring buffer instance created by @ref ring_buf_create with latency tracing enabled.
+ * @param[in] buffer New buffer to store the elements. Same requirements as in @ref ring_buf_resize.
+ * @param[in] timestamps New buffer to store the push timestamps, must be of size num_elems. Must not overlap with the
+ * current timestamps buffer. Cannot be NULL.
+ * @param[in] num_elems New maximum number of elements that can be in the buffer at the same time. Must be > 0.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully moved the ring buffer to the new buffers.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA @p num_elems is less than the number of currently stored elements. The ring
+ * buffer is left unchanged.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL, @p buffer is NULL, @p timestamps is NULL, @p num_elems is 0,
+ * or latency tracing is not enabled for @p self.
+ */
+uint8_t ring_buf_resize_traced(RingBuf self, void *const buffer, uint64_t *const timestamps, size_t num_elems);
+
+/**
+ * @brief Remove stored elements in batches, passing each batch to a callback directly from the ring buffer's storage.
+ *
+ * All elements that are stored when this function is called are drained, in batches of up to cfg->max_batch
+ * contiguous elements. A batch never wraps around the end of the storage. While the callback processes a batch, the
+ * start of the next batch is prefetched.
+ *
+ * If fewer than cfg->min_batch elements are stored, nothing is drained, unless cfg->max_wait consecutive calls have
+ * already returned without draining for this reason.
+ *
+ * @param[in] self Ring buffer instance created by @ref ring_buf_create.
+ * @param[in] cfg Drain thresholds.
+ * @param[in] cb Callback to pass batches to.
+ * @param[in] user_data User data argument to pass to @p cb.
+ * @param[out] num_drained Number of drained elements is written to this parameter. Can be NULL.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Drained at least one element.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA Buffer is empty, or draining was held back to wait for min_batch elements.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL, @p cfg is NULL, @p cb is NULL, one of the fields in @p cfg
+ * is invalid, or @p self uses struct-of-arrays layout.
+ */
+uint8_t ring_buf_drain(RingBuf self, const RingBufDrainCfg *const cfg, RingBufDrainCb cb, void *user_data,
+                       size_t *const num_drained);
+
+/**
+ * @brief Get a snapshot of the residency time histogram.
+ *
+ * @param[in] self Ring buffer instance created by @ref ring_buf_create with latency tracing enabled.
+ * @param[out] hist Snapshot of the histogram is written to this parameter.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully got the snapshot.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA Latency tracing is not enabled for @p self.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL or @p hist is NULL.
+ */
+uint8_t ring_buf_get_latency_hist(RingBuf self, RingBufLatencyHist *const hist);
+
+/**
+ * @brief Get a percentile of the values recorded in a latency histogram.
+ *
+ * @param[in] hist Histogram, e.g. a snapshot returned by @ref ring_buf_get_latency_hist.
+ * @param[in] permille Percentile in parts per thousand, e.g. 500 for p50, 990 for p99, 999 for p99.9. Must be <= 1000.
+ * @param[out] value The largest value that is in the same histogram bucket as the requested percentile, but not more
+ * than the largest recorded value.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully got the percentile.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA No values were recorded in @p hist.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p hist is NULL, @p value is NULL, or @p permille > 1000.
+ */
+uint8_t ring_buf_latency_hist_get_percentile(const RingBufLatencyHist *const hist, uint32_t permille,
+                                             uint64_t *const value);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,273 @@
+#include <string.h>
+#include <stdbool.h>
+
+#include "ring_buf_cold.h"
+#include "ring_buf_cold_private.h"
+
+/**
+ * @brief Check whether init config is valid.
+ *
+ * @param[in] cfg Init config.
+ *
+ * @retval true Init config is valid.
+ * @retval false Init config is invalid.
+ */
+static bool is_valid_cfg(const RingBufColdInitCfg *const cfg)
+{
+    // clang-format off
+    return (
+        cfg
+        && cfg->get_inst_buf
+        && (cfg->elem_size > 0)
+        && (cfg->block_size >= RING_BUF_COLD_MIN_BLOCK_SIZE(cfg->elem_size))
+        && (cfg->block_size <= UINT16_MAX)
+        && (cfg->num_blocks > 0)
+        && cfg->buffer
+        && cfg->prev_elem
+    );
+    // clang-format on
+}
+
+/**
+ * @brief Get pointer to the start of a block.
+ *
+ * @param[in] self Cold storage instance.
+ * @param[in] block_idx Block index.
+ *
+ * @return uint8_t * Pointer to the first byte of the block header.
+ */
+static uint8_t *get_block(RingBufCold self, size_t block_idx)
+{
+    return self->buffer + (block_idx * self->block_size);
+}
+
+/**
+ * @brief Get number of bytes used in a block, including the block header.
+ *
+ * @param[in] self Cold storage instance.
+ * @param[in] block_idx Block index.
+ *
+ * @return size_t Number of used bytes.
+ */
+static size_t get_block_used(RingBufCold self, size_t block_idx)
+{
+    const uint8_t *const block = get_block(self, block_idx);
+    return (size_t)block[0] | ((size_t)block[1] << 8);
+}
+
+/**
+ * @brief Set number of bytes used in a block, including the block header.
+ *
+ * @param[in] self Cold storage instance.
+ * @param[in] block_idx Block index.
+ * @param[in] used Number of used bytes.
+ */
+static void set_block_used(RingBufCold self, size_t block_idx, size_t used)
+{
+    uint8_t *const block = get_block(self, block_idx);
+    block[0] = (uint8_t)(used & 0xFF);
+    block[1] = (uint8_t)((used >> 8) & 0xFF);
+}
+
+/**
+ * @brief Make the block at head_block empty and start encoding from an all-zero element.
+ *
+ * @param[in] self Cold storage instance.
+ */
+static void start_block(RingBufCold self)
+{
+    set_block_used(self, self->head_block, RING_BUF_COLD_BLOCK_HEADER_SIZE);
+    memset(self->prev_elem, 0, self->elem_size);
+    self->group_offset = 0;
+    self->group_num_diffs = 0;
+}
+
+/**
+ * @brief Check whether a byte is marked as changed in a bitmap.
+ *
+ * @param[in] bitmap Bitmap with one bit per element byte.
+ * @param[in] idx Byte index in the element.
+ *
+ * @retval true Byte is marked as changed.
+ * @retval false Byte is not marked as changed.
+ */
+static bool is_bit_set(const uint8_t *const bitmap, size_t idx)
+{
+    return (bitmap[idx / 8] & (1U << (idx % 8))) != 0;
+}
+
+/**
+ * @brief Get the number of bytes needed to encode an element against prev_elem in the block at head_block.
+ *
+ * The element can join the current group if every byte that changed is covered by the group bitmap and the group is
+ * not full. It only joins if that is cheaper than starting a new group, so that a group with a stale bitmap that
+ * covers more bytes than needed does not keep costing extra bytes for every following element.
+ *
+ * @param[in] self Cold storage instance.
+ * @param[in] elem Element to encode.
+ * @param[out] join_group true if the element is to be added to the current group, false if it starts a new group.
+ *
+ * @return size_t Number of bytes to encode the element.
+ */
+static size_t get_encoded_size(RingBufCold self, const uint8_t *const elem, bool *const join_group)
+{
+    const uint8_t *const group = get_block(self, self->head_block) + self->group_offset;
+    const size_t bitmap_size = RING_BUF_COLD_BITMAP_SIZE(self->elem_size);
+    bool is_covered = (self->group_offset != 0) && (group[bitmap_size] < UINT8_MAX);
+    size_t num_changed = 0;
+
+    for (size_t i = 0; i < self->elem_size; i++) {
+        if (elem[i] != self->prev_elem[i]) {
+            num_changed++;
+            is_covered = is_covered && is_bit_set(group, i);
+        }
+    }
+
+    const size_t new_group_size = RING_BUF_COLD_GROUP_HEADER_SIZE(self->elem_size) + num_changed;
+    *join_group = is_covered && (self->group_num_diffs < new_group_size);
+    return *join_group ? self->group_num_diffs : new_group_size;
+}
+
+uint8_t ring_buf_cold_create(RingBufCold *const inst, const RingBufColdInitCfg *const cfg)
+{
+    if (!inst || !is_valid_cfg(cfg)) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    *inst = cfg->get_inst_buf(cfg->get_inst_buf_user_data);
+    if (!(*inst)) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+
+    (*inst)->buffer = (uint8_t *)cfg->buffer;
+    (*inst)->prev_elem = (uint8_t *)cfg->prev_elem;
+    (*inst)->elem_size = cfg->elem_size;
+    (*inst)->block_size = cfg->block_size;
+    (*inst)->num_blocks = cfg->num_blocks;
+    (*inst)->head_block = 0;
+    (*inst)->tail_block = 0;
+    (*inst)->num_used_blocks = 0;
+    (*inst)->group_offset = 0;
+    (*inst)->group_num_diffs = 0;
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_cold_append(RingBufCold self, const void *const element)
+{
+    if (!self || !element) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    if (self->num_used_blocks == 0) {
+        self->num_used_blocks = 1;
+        start_block(self);
+    }
+
+    const uint8_t *const elem = (const uint8_t *)element;
+    bool join_group = false;
+    size_t encoded_size = get_encoded_size(self, elem, &join_group);
+    if ((get_block_used(self, self->head_block) + encoded_size) > self->block_size) {
+        /* Element does not fit into the current block, move on to the next one */
+        self->head_block = (self->head_block + 1) % self->num_blocks;
+        if (self->num_used_blocks == self->num_blocks) {
+            /* All blocks are used - discard the oldest one */
+            self->tail_block = (self->tail_block + 1) % self->num_blocks;
+        } else {
+            self->num_used_blocks++;
+        }
+        start_block(self);
+        /* Fits for sure, an empty block has room for RING_BUF_COLD_MAX_ENCODED_SIZE */
+        encoded_size = get_encoded_size(self, elem, &join_group);
+    }
+
+    uint8_t *const block = get_block(self, self->head_block);
+    const size_t used = get_block_used(self, self->head_block);
+    const size_t bitmap_size = RING_BUF_COLD_BITMAP_SIZE(self->elem_size);
+    uint8_t *out = block + used;
+
+    if (join_group) {
+        block[self->group_offset + bitmap_size]++;
+    } else {
+        uint8_t *const group = out;
+        memset(group, 0, bitmap_size);
+        for (size_t i = 0; i < self->elem_size; i++) {
+            if (elem[i] != self->prev_elem[i]) {
+                group[i / 8] |= (uint8_t)(1U << (i % 8));
+            }
+        }
+        group[bitmap_size] = 1;
+        self->group_offset = used;
+        self->group_num_diffs = encoded_size - RING_BUF_COLD_GROUP_HEADER_SIZE(self->elem_size);
+        out += RING_BUF_COLD_GROUP_HEADER_SIZE(self->elem_size);
+    }
+
+    /* Every byte covered by the group bitmap is stored, even if it did not change for this element */
+    const uint8_t *const bitmap = block + self->group_offset;
+    for (size_t i = 0; i < self->elem_size; i++) {
+        if (is_bit_set(bitmap, i)) {
+            *out++ = elem[i] ^ self->prev_elem[i];
+        }
+    }
+
+    set_block_used(self, self->head_block, used + encoded_size);
+    memcpy(self->prev_elem, elem, self->elem_size);
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_cold_iter_init(RingBufCold self, RingBufColdIter *const iter)
+{
+    if (!self || !iter) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    iter->block_idx = self->tail_block;
+    iter->blocks_left = self->num_used_blocks;
+    iter->offset = RING_BUF_COLD_BLOCK_HEADER_SIZE;
+    iter->group_offset = 0;
+    iter->group_elems_left = 0;
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+uint8_t ring_buf_cold_iter_next(RingBufCold self, RingBufColdIter *const iter, void *const element)
+{
+    if (!self || !iter || !element) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    /* Elements that did not change take no bytes, so the rest of a group can start at the end of the block */
+    while ((iter->group_elems_left == 0) && (iter->blocks_left > 0) &&
+           (iter->offset >= get_block_used(self, iter->block_idx))) {
+        iter->block_idx = (iter->block_idx + 1) % self->num_blocks;
+        iter->blocks_left--;
+        iter->offset = RING_BUF_COLD_BLOCK_HEADER_SIZE;
+        iter->group_elems_left = 0;
+    }
+    if (iter->blocks_left == 0) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+
+    uint8_t *const elem = (uint8_t *)element;
+    if (iter->offset == RING_BUF_COLD_BLOCK_HEADER_SIZE) {
+        /* First element in a block is encoded against an all-zero element */
+        memset(elem, 0, self->elem_size);
+    }
+
+    const uint8_t *const block = get_block(self, iter->block_idx);
+    if (iter->group_elems_left == 0) {
+        iter->group_offset = iter->offset;
+        iter->group_elems_left = block[iter->offset + RING_BUF_COLD_BITMAP_SIZE(self->elem_size)];
+        iter->offset += RING_BUF_COLD_GROUP_HEADER_SIZE(self->elem_size);
+    }
+
+    const uint8_t *const bitmap = block + iter->group_offset;
+    const uint8_t *in = block + iter->offset;
+    for (size_t i = 0; i < self->elem_size; i++) {
+        if (is_bit_set(bitmap, i)) {
+            elem[i] ^= *in++;
+        }
+    }
+
+    iter->offset = (size_t)(in - block);
+    iter->group_elems_left--;
+    return RING_BUF_RESULT_CODE_OK;
+}
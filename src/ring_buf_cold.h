@@ -0,0 +1,140 @@
+#ifndef SRC_RING_BUF_COLD_H
+#define SRC_RING_BUF_COLD_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ring_buf.h"
+
+/**
+ * Compressed cold storage for elements that are evicted from the hot RingBuf.
+ *
+ * Elements are appended one by one. Each element is XOR-encoded against the previously appended element and only
+ * the bytes that changed are stored. Which bytes are stored is described by a bitmap with one bit per element byte.
+ * Consecutive elements that change in the same bytes share one bitmap: they are stored as a group of a bitmap, an
+ * element count and then the stored bytes of every element. Records with fields that change slowly therefore take
+ * little more than their changed bytes each, also when the element is large and the bitmap is wide.
+ *
+ * The storage is split into fixed-size blocks. The first element in every block is encoded against an all-zero
+ * element, so every block can be decoded on its own. When all blocks are full, the oldest block is discarded as a
+ * whole to make space for new elements - cold storage always keeps the newest elements.
+ *
+ * Typical usage is a tiered buffer: the application pushes into a RingBuf, and when @ref ring_buf_push returns
+ * RING_BUF_RESULT_CODE_NO_DATA, it pops the oldest element from the RingBuf, appends it to the cold storage and
+ * then retries the push.
+ */
+typedef struct RingBufColdStruct *RingBufCold;
+
+typedef struct {
+    /** Function to get memory buffer for the instance. Must return a pointer to memory of size sizeof(struct
+     * RingBufColdStruct). Same semantics as @ref RingBufGetInstBuf. Cannot be NULL. */
+    RingBufGetInstBuf get_inst_buf;
+    /** User data argument to pass to the get_inst_buf function. */
+    void *get_inst_buf_user_data;
+    /** Size of one element in bytes. Must be > 0. */
+    size_t elem_size;
+    /** Size of one block in bytes. Must be large enough to hold at least one element in the worst case, i.e. >= @ref
+     * RING_BUF_COLD_MIN_BLOCK_SIZE(elem_size). Must be <= UINT16_MAX. */
+    size_t block_size;
+    /** Number of blocks. Must be > 0. */
+    size_t num_blocks;
+    /** Buffer to store the blocks, must be of size (num_blocks * block_size). Cannot be NULL. */
+    void *buffer;
+    /** Buffer that holds a copy of the last appended element, must be of size elem_size. Cannot be NULL. */
+    void *prev_elem;
+} RingBufColdInitCfg;
+
+/** Number of bytes in the header of every block. */
+#define RING_BUF_COLD_BLOCK_HEADER_SIZE 2
+
+/** Size of the bitmap that describes which bytes are stored for the elements of a group. */
+#define RING_BUF_COLD_BITMAP_SIZE(elem_size) (((elem_size) + 7) / 8)
+
+/** Size of the header of a group of elements: bitmap followed by a one-byte element count. */
+#define RING_BUF_COLD_GROUP_HEADER_SIZE(elem_size) (RING_BUF_COLD_BITMAP_SIZE(elem_size) + 1)
+
+/** Maximum number of bytes that one encoded element can take. */
+#define RING_BUF_COLD_MAX_ENCODED_SIZE(elem_size) (RING_BUF_COLD_GROUP_HEADER_SIZE(elem_size) + (elem_size))
+
+/** Minimum valid block size for elements of size elem_size. */
+#define RING_BUF_COLD_MIN_BLOCK_SIZE(elem_size)                                                                        \
+    (RING_BUF_COLD_BLOCK_HEADER_SIZE + RING_BUF_COLD_MAX_ENCODED_SIZE(elem_size))
+
+/**
+ * @brief Iterator over the elements in cold storage, from oldest to newest.
+ *
+ * Initialize with @ref ring_buf_cold_iter_init. Fields are private to the ring_buf_cold module.
+ */
+typedef struct {
+    size_t block_idx;
+    size_t blocks_left;
+    size_t offset;
+    size_t group_offset;
+    size_t group_elems_left;
+} RingBufColdIter;
+
+/**
+ * @brief Create a cold storage instance.
+ *
+ * @param[out] inst Created instance is written to this parameter.
+ * @param[in] cfg Init config.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully created instance.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA cfg->get_inst_buf returned NULL.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p inst is NULL, @p cfg is NULL, or one of the fields in @p cfg is invalid.
+ */
+uint8_t ring_buf_cold_create(RingBufCold *const inst, const RingBufColdInitCfg *const cfg);
+
+/**
+ * @brief Append an element to cold storage.
+ *
+ * If there is no space left, the oldest block is discarded. Appending never fails because of lack of space.
+ *
+ * @param[in] self Cold storage instance created by @ref ring_buf_cold_create.
+ * @param[in] element Element to append. Must point to a buffer of size "elem_size" bytes that was passed to the init
+ * cfg.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully appended the element.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL or @p element is NULL.
+ */
+uint8_t ring_buf_cold_append(RingBufCold self, const void *const element);
+
+/**
+ * @brief Initialize an iterator to point to the oldest element in cold storage.
+ *
+ * The iterator is invalidated by @ref ring_buf_cold_append.
+ *
+ * @param[in] self Cold storage instance created by @ref ring_buf_cold_create.
+ * @param[out] iter Iterator to initialize.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully initialized the iterator.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL or @p iter is NULL.
+ */
+uint8_t ring_buf_cold_iter_init(RingBufCold self, RingBufColdIter *const iter);
+
+/**
+ * @brief Decode the next element and advance the iterator.
+ *
+ * Elements are decoded in place: @p element must hold the element returned by the previous call with the same
+ * iterator. Its contents must not be modified between the calls.
+ *
+ * @param[in] self Cold storage instance created by @ref ring_buf_cold_create.
+ * @param[in,out] iter Iterator initialized by @ref ring_buf_cold_iter_init.
+ * @param[in,out] element Buffer of size "elem_size" bytes to write the decoded element into.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully decoded the next element.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA There are no more elements.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p self is NULL, @p iter is NULL, or @p element is NULL.
+ */
+uint8_t ring_buf_cold_iter_next(RingBufCold self, RingBufColdIter *const iter, void *const element);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_RING_BUF_COLD_H */
@@ -0,0 +1,39 @@
+#ifndef SRC_RING_BUF_COLD_PRIVATE_H
+#define SRC_RING_BUF_COLD_PRIVATE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+struct RingBufColdStruct {
+    /** Buffer to hold the blocks. uint8_t so that it is easy to do byte pointer arithmetic on it. */
+    uint8_t *buffer;
+    /** Copy of the last appended element. Encoding of the next element is relative to it. */
+    uint8_t *prev_elem;
+    /** Size of one element in bytes. */
+    size_t elem_size;
+    /** Size of one block in bytes. */
+    size_t block_size;
+    /** Total number of blocks. */
+    size_t num_blocks;
+    /** Index of the block that elements are currently appended to. */
+    size_t head_block;
+    /** Index of the oldest block. */
+    size_t tail_block;
+    /** Number of blocks that contain at least one element. */
+    size_t num_used_blocks;
+    /** Offset of the current group in head_block, 0 if no group was started in head_block yet. */
+    size_t group_offset;
+    /** Number of bytes marked as changed in the bitmap of the current group. */
+    size_t group_num_diffs;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_RING_BUF_COLD_PRIVATE_H */
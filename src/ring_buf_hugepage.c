@@ -0,0 +1,282 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "ring_buf_hugepage.h"
+#include "ring_buf_private.h"
+
+/** Element storage starts at this alignment after the instance, so that elements do not share a cache line with it,
+ * and so that columns in struct-of-arrays layout are aligned */
+#define RING_BUF_HUGEPAGE_STORAGE_ALIGN RING_BUF_SOA_COLUMN_ALIGN
+
+/** Memory policy for mbind, from linux/mempolicy.h */
+#define RING_BUF_HUGEPAGE_MPOL_BIND 2
+
+/** Highest supported NUMA node index + 1 */
+#define RING_BUF_HUGEPAGE_MAX_NUMA_NODES 1024
+
+#define RING_BUF_HUGEPAGE_BITS_PER_LONG (8 * sizeof(unsigned long))
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+/** Explicitly request 2MB pages, the default huge page size may be larger (e.g. 1GB) */
+#define RING_BUF_HUGEPAGE_MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+
+/**
+ * @brief Check whether field schema in allocation config is valid.
+ *
+ * @param[in] cfg Allocation config with field_sizes not NULL.
+ *
+ * @retval true Every field is at least one byte and field sizes add up to elem_size.
+ * @retval false Field schema is invalid.
+ */
+static bool is_valid_field_sizes(const RingBufHugepageCfg *const cfg)
+{
+    if (cfg->num_fields == 0) {
+        return false;
+    }
+
+    size_t total_size = 0;
+    for (size_t i = 0; i < cfg->num_fields; i++) {
+        if (cfg->field_sizes[i] == 0) {
+            return false;
+        }
+        total_size += cfg->field_sizes[i];
+    }
+    return (total_size == cfg->elem_size);
+}
+
+/**
+ * @brief Check whether allocation config is valid.
+ *
+ * @param[in] cfg Allocation config.
+ *
+ * @retval true Allocation config is valid.
+ * @retval false Allocation config is invalid.
+ */
+static bool is_valid_cfg(const RingBufHugepageCfg *const cfg)
+{
+    // clang-format off
+    return (
+        cfg
+        && (cfg->elem_size > 0)
+        && (cfg->num_elems > 0)
+        && (cfg->num_elems <= (SIZE_MAX / 2) / cfg->elem_size)
+        && (cfg->numa_node >= RING_BUF_HUGEPAGE_NO_NUMA_NODE)
+        && (cfg->numa_node < RING_BUF_HUGEPAGE_MAX_NUMA_NODES)
+        && (!cfg->field_sizes || is_valid_field_sizes(cfg))
+    );
+    // clang-format on
+}
+
+/**
+ * @brief Round a value up to a multiple of align.
+ *
+ * @param[in] value Value to round.
+ * @param[in] align Alignment, must be a power of two.
+ *
+ * @return size_t Rounded value.
+ */
+static size_t align_up(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+/**
+ * @brief Get size of the element storage.
+ *
+ * @param[in] cfg Allocation config.
+ *
+ * @return size_t Storage size in bytes, including column padding in struct-of-arrays layout.
+ */
+static size_t get_storage_size(const RingBufHugepageCfg *const cfg)
+{
+    if (!cfg->field_sizes) {
+        return cfg->num_elems * cfg->elem_size;
+    }
+
+    size_t storage_size = 0;
+    for (size_t i = 0; i < cfg->num_fields; i++) {
+        storage_size += RING_BUF_SOA_COLUMN_SIZE(cfg->num_elems, cfg->field_sizes[i]);
+    }
+    return storage_size;
+}
+
+/**
+ * @brief Check whether a NUMA node has enough free 2MB huge pages.
+ *
+ * Huge pages are reserved at mmap time from the system-wide pool, not from a particular node. If the mapping is then
+ * bound to a node that has no free huge pages, faulting it in raises SIGBUS. This check avoids that.
+ *
+ * @param[in] numa_node NUMA node index.
+ * @param[in] num_pages Number of required huge pages.
+ *
+ * @retval true The node has at least num_pages free huge pages.
+ * @retval false The node has fewer free huge pages, or the number of free huge pages could not be read.
+ */
+static bool node_has_free_huge_pages(int numa_node, size_t num_pages)
+{
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/hugepages/hugepages-2048kB/free_hugepages",
+             numa_node);
+
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return false;
+    }
+    unsigned long free_pages = 0;
+    const int num_read = fscanf(file, "%lu", &free_pages);
+    fclose(file);
+    return (num_read == 1) && (free_pages >= num_pages);
+}
+
+/**
+ * @brief Map anonymous memory backed by explicit 2MB huge pages.
+ *
+ * @param[in] size Size of the mapping, multiple of RING_BUF_HUGEPAGE_SIZE.
+ *
+ * @return void * Start of the mapping, or NULL if no huge pages are available.
+ */
+static void *map_explicit_huge_pages(size_t size)
+{
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | RING_BUF_HUGEPAGE_MAP_HUGE_2MB;
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    return (map != MAP_FAILED) ? map : NULL;
+}
+
+/**
+ * @brief Map 2MB-aligned anonymous memory and ask for transparent huge pages.
+ *
+ * Regular mappings are only guaranteed to be page-aligned, and THP cannot back the partial 2MB regions at either end
+ * of an unaligned mapping. So a larger region is mapped, and the unused parts before and after the aligned start are
+ * unmapped.
+ *
+ * @param[in] size Size of the mapping, multiple of RING_BUF_HUGEPAGE_SIZE.
+ *
+ * @return void * Start of the mapping, or NULL if failed to map memory.
+ */
+static void *map_transparent_huge_pages(size_t size)
+{
+    const size_t padded_size = size + RING_BUF_HUGEPAGE_SIZE;
+    uint8_t *const padded = (uint8_t *)mmap(NULL, padded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                                            -1, 0);
+    if ((void *)padded == MAP_FAILED) {
+        return NULL;
+    }
+
+    uint8_t *const map = (uint8_t *)align_up((uintptr_t)padded, RING_BUF_HUGEPAGE_SIZE);
+    const size_t head_size = (size_t)(map - padded);
+    const size_t tail_size = padded_size - head_size - size;
+    if (head_size > 0) {
+        (void)munmap(padded, head_size);
+    }
+    if (tail_size > 0) {
+        (void)munmap(map + size, tail_size);
+    }
+
+    /* Not fatal if THP is disabled, memory is still usable */
+    (void)madvise(map, size, MADV_HUGEPAGE);
+    return map;
+}
+
+/**
+ * @brief Bind memory to a NUMA node.
+ *
+ * @param[in] map Start of the mapping.
+ * @param[in] size Size of the mapping.
+ * @param[in] numa_node NUMA node index.
+ *
+ * @retval true Successfully bound memory.
+ * @retval false mbind failed.
+ */
+static bool bind_to_numa_node(void *map, size_t size, int numa_node)
+{
+    unsigned long nodemask[RING_BUF_HUGEPAGE_MAX_NUMA_NODES / RING_BUF_HUGEPAGE_BITS_PER_LONG];
+    memset(nodemask, 0, sizeof(nodemask));
+    const size_t node = (size_t)numa_node;
+    nodemask[node / RING_BUF_HUGEPAGE_BITS_PER_LONG] = 1UL << (node % RING_BUF_HUGEPAGE_BITS_PER_LONG);
+
+    /* The kernel uses one bit less than maxnode, hence + 1 */
+    const unsigned long maxnode = RING_BUF_HUGEPAGE_MAX_NUMA_NODES + 1;
+    long rc = syscall(SYS_mbind, map, size, RING_BUF_HUGEPAGE_MPOL_BIND, nodemask, maxnode, 0);
+    return (rc == 0);
+}
+
+uint8_t ring_buf_hugepage_alloc(RingBufHugepageAlloc *const alloc, const RingBufHugepageCfg *const cfg)
+{
+    if (!alloc || !is_valid_cfg(cfg)) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    const size_t storage_offset = align_up(sizeof(struct RingBufStruct), RING_BUF_HUGEPAGE_STORAGE_ALIGN);
+    const size_t map_size = align_up(storage_offset + get_storage_size(cfg), RING_BUF_HUGEPAGE_SIZE);
+
+    /* Explicit huge pages bound to a node are only safe to fault in if that node has enough of them free */
+    const size_t num_huge_pages = map_size / RING_BUF_HUGEPAGE_SIZE;
+    const bool try_explicit = (cfg->numa_node == RING_BUF_HUGEPAGE_NO_NUMA_NODE) ||
+                              node_has_free_huge_pages(cfg->numa_node, num_huge_pages);
+
+    uint8_t *map = try_explicit ? (uint8_t *)map_explicit_huge_pages(map_size) : NULL;
+    const bool explicit_huge_pages = (map != NULL);
+    if (!map) {
+        /* No huge pages reserved - fall back to regular pages and ask for transparent huge pages */
+        map = (uint8_t *)map_transparent_huge_pages(map_size);
+    }
+    if (!map) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+
+    bool numa_bound = false;
+    if (cfg->numa_node != RING_BUF_HUGEPAGE_NO_NUMA_NODE) {
+        numa_bound = bind_to_numa_node(map, map_size, cfg->numa_node);
+    }
+
+    /* Pre-fault all pages, so that the ring buffer does not take page faults on the hot path. Pages are placed
+     * according to the NUMA policy set above, or on the calling thread's node otherwise. */
+    memset(map, 0, map_size);
+
+    alloc->map = map;
+    alloc->map_size = map_size;
+    alloc->inst_buf = map;
+    alloc->buffer = map + storage_offset;
+    alloc->explicit_huge_pages = explicit_huge_pages;
+    alloc->numa_bound = numa_bound;
+    alloc->inst_buf_taken = false;
+    return RING_BUF_RESULT_CODE_OK;
+}
+
+void *ring_buf_hugepage_get_inst_buf(void *user_data)
+{
+    RingBufHugepageAlloc *const alloc = (RingBufHugepageAlloc *)user_data;
+    if (!alloc || !alloc->inst_buf || alloc->inst_buf_taken) {
+        return NULL;
+    }
+
+    alloc->inst_buf_taken = true;
+    return alloc->inst_buf;
+}
+
+uint8_t ring_buf_hugepage_free(RingBufHugepageAlloc *const alloc)
+{
+    if (!alloc || !alloc->map) {
+        return RING_BUF_RESULT_CODE_INVAL_ARG;
+    }
+
+    if (munmap(alloc->map, alloc->map_size) != 0) {
+        return RING_BUF_RESULT_CODE_NO_DATA;
+    }
+    alloc->map = NULL;
+    alloc->inst_buf = NULL;
+    alloc->buffer = NULL;
+    alloc->map_size = 0;
+    return RING_BUF_RESULT_CODE_OK;
+}
@@ -0,0 +1,122 @@
+#ifndef SRC_RING_BUF_HUGEPAGE_H
+#define SRC_RING_BUF_HUGEPAGE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ring_buf.h"
+
+/**
+ * Linux-only helper that provides memory for a RingBuf instance and its element storage from huge pages.
+ *
+ * The instance and the element storage are placed in one anonymous mapping. The helper first tries explicit 2MB huge
+ * pages (MAP_HUGETLB | MAP_HUGE_2MB). If none are reserved on the system, or the requested NUMA node does not have
+ * enough of them free, it falls back to a 2MB-aligned mapping of regular pages with transparent huge pages requested
+ * via madvise(MADV_HUGEPAGE). The mapping is optionally bound to a NUMA node and is pre-faulted, so
+ * that the ring buffer does not take page faults on the hot path.
+ *
+ * Usage:
+ * ```
+ * RingBufHugepageCfg hp_cfg = {.elem_size = sizeof(struct Sample), .num_elems = 1 << 20, .numa_node = 0};
+ * RingBufHugepageAlloc alloc;
+ * ring_buf_hugepage_alloc(&alloc, &hp_cfg);
+ *
+ * RingBufInitCfg cfg = {
+ *     .get_inst_buf = ring_buf_hugepage_get_inst_buf,
+ *     .get_inst_buf_user_data = &alloc,
+ *     .elem_size = hp_cfg.elem_size,
+ *     .num_elems = hp_cfg.num_elems,
+ *     .buffer = alloc.buffer,
+ * };
+ * ring_buf_create(&inst, &cfg);
+ * ```
+ */
+
+/** Huge page size that mappings are rounded up to. */
+#define RING_BUF_HUGEPAGE_SIZE (2UL * 1024UL * 1024UL)
+
+/** Pass as numa_node to not bind the memory to any NUMA node. */
+#define RING_BUF_HUGEPAGE_NO_NUMA_NODE (-1)
+
+typedef struct {
+    /** Size of one element in bytes. Must be > 0. */
+    size_t elem_size;
+    /** Maximum number of elements that can be in the buffer at the same time. Must be > 0. */
+    size_t num_elems;
+    /** NUMA node to bind the memory to, or RING_BUF_HUGEPAGE_NO_NUMA_NODE. */
+    int numa_node;
+    /** Field schema of the ring buffer that will use the storage, same as RingBufInitCfg::field_sizes. If not NULL,
+     * the storage is sized for struct-of-arrays layout. NULL sizes it for the default array-of-structs layout. */
+    const size_t *field_sizes;
+    /** Number of fields in field_sizes. Must be > 0 if field_sizes is not NULL. */
+    size_t num_fields;
+} RingBufHugepageCfg;
+
+typedef struct {
+    /** Memory for the RingBuf instance. Returned once by @ref ring_buf_hugepage_get_inst_buf. */
+    void *inst_buf;
+    /** Element storage to pass as RingBufInitCfg::buffer. Aligned to RING_BUF_SOA_COLUMN_ALIGN. Size is (num_elems *
+     * elem_size), or the sum of @ref RING_BUF_SOA_COLUMN_SIZE(num_elems, field_size) over all fields if
+     * RingBufHugepageCfg::field_sizes is set. */
+    void *buffer;
+    /** Start of the mapping. */
+    void *map;
+    /** Size of the mapping in bytes. */
+    size_t map_size;
+    /** true if the mapping is backed by explicit huge pages, false if it relies on transparent huge pages. */
+    bool explicit_huge_pages;
+    /** true if the mapping was bound to the requested NUMA node with mbind. */
+    bool numa_bound;
+    /** true if inst_buf was already returned by @ref ring_buf_hugepage_get_inst_buf. */
+    bool inst_buf_taken;
+} RingBufHugepageAlloc;
+
+/**
+ * @brief Allocate, bind and pre-fault memory for one RingBuf instance and its element storage.
+ *
+ * If binding to the NUMA node with mbind fails, e.g. because the kernel is built without NUMA support, the memory is
+ * still allocated and pre-faulted by the calling thread, so it is placed on the calling thread's node (first-touch
+ * policy). alloc->numa_bound is false in this case.
+ *
+ * @param[out] alloc Allocation is written to this parameter.
+ * @param[in] cfg Allocation config.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully allocated memory.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA Failed to map memory.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p alloc is NULL, @p cfg is NULL, or one of the fields in @p cfg is invalid.
+ */
+uint8_t ring_buf_hugepage_alloc(RingBufHugepageAlloc *const alloc, const RingBufHugepageCfg *const cfg);
+
+/**
+ * @brief Implementation of @ref RingBufGetInstBuf that returns the instance memory of an allocation.
+ *
+ * @param user_data Pointer to a RingBufHugepageAlloc initialized by @ref ring_buf_hugepage_alloc.
+ *
+ * @return void * alloc->inst_buf on the first call, NULL on subsequent calls or if @p user_data is NULL.
+ */
+void *ring_buf_hugepage_get_inst_buf(void *user_data);
+
+/**
+ * @brief Unmap memory of an allocation.
+ *
+ * The RingBuf instance that uses this memory must not be used after this call.
+ *
+ * @param[in] alloc Allocation initialized by @ref ring_buf_hugepage_alloc.
+ *
+ * @retval RING_BUF_RESULT_CODE_OK Successfully unmapped memory.
+ * @retval RING_BUF_RESULT_CODE_NO_DATA munmap failed. @p alloc is left unchanged.
+ * @retval RING_BUF_RESULT_CODE_INVAL_ARG @p alloc is NULL or was already freed.
+ */
+uint8_t ring_buf_hugepage_free(RingBufHugepageAlloc *const alloc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_RING_BUF_HUGEPAGE_H */
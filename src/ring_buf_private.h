@@ -10,6 +10,8 @@ extern "C"
 #include <stdint.h>
 #include <stddef.h>
 
+#include "ring_buf.h"
+
 struct RingBufStruct {
     /** Buffer to hold the elements. uint8_t so that it is easy to do byte pointer arithmetic on it. */
     uint8_t *buffer;
@@ -17,9 +19,21 @@ struct RingBufStruct {
     size_t elem_size;
     /** Maximum number of elements that can be in the buffer at the same time. */
     size_t num_elems;
+    /** Field schema for struct-of-arrays layout, NULL for array-of-structs layout. */
+    const size_t *field_sizes;
+    /** Number of fields in field_sizes. */
+    size_t num_fields;
     size_t head;
     size_t tail;
     bool full;
+    /** Latency tracing. NULL get_timestamp means that latency tracing is disabled. */
+    RingBufGetTimestamp get_timestamp;
+    void *get_timestamp_user_data;
+    /** Push timestamp of the element in every slot. */
+    uint64_t *timestamps;
+    RingBufLatencyHist *latency_hist;
+    /** Number of consecutive ring_buf_drain calls that returned without draining to wait for min_batch elements. */
+    size_t drain_wait_cnt;
 };
 
 #ifdef __cplusplus
@@ -469,3 +469,979 @@ TEST(RingBuf, ElemNull)
     uint8_t rc = ring_buf_pop(ring_buf, NULL);
     CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, rc);
 }
+
+static size_t get_count()
+{
+    size_t count = 0;
+    uint8_t rc = ring_buf_get_count(ring_buf, &count);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+    return count;
+}
+
+TEST(RingBuf, GetCountTracksPushAndPop)
+{
+    uint8_t buffer[3];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint8_t);
+    init_cfg.num_elems = 3;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+    CHECK_EQUAL(0, get_count());
+
+    uint8_t elem = 0x11;
+    push(&elem);
+    push(&elem);
+    CHECK_EQUAL(2, get_count());
+    push(&elem);
+    CHECK_EQUAL(3, get_count());
+
+    uint8_t popped_elem;
+    pop(&popped_elem);
+    CHECK_EQUAL(2, get_count());
+
+    /* Wrap around */
+    push(&elem);
+    CHECK_EQUAL(3, get_count());
+}
+
+TEST(RingBuf, GetCountInvalArg)
+{
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    size_t count;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_count(NULL, &count));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_count(ring_buf, NULL));
+}
+
+TEST(RingBuf, PeekDoesNotRemoveElements)
+{
+    uint16_t buffer[3];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint16_t);
+    init_cfg.num_elems = 3;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint16_t elem1 = 0x1111;
+    uint16_t elem2 = 0x2222;
+    push(&elem1);
+    push(&elem2);
+
+    uint16_t peeked_elem = 0;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_peek(ring_buf, 1, &peeked_elem));
+    CHECK_EQUAL(elem2, peeked_elem);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_peek(ring_buf, 0, &peeked_elem));
+    CHECK_EQUAL(elem1, peeked_elem);
+
+    /* Elements are still there */
+    uint16_t popped_elem = 0;
+    pop(&popped_elem);
+    CHECK_EQUAL(elem1, popped_elem);
+    pop(&popped_elem);
+    CHECK_EQUAL(elem2, popped_elem);
+}
+
+TEST(RingBuf, PeekWrapsAround)
+{
+    uint8_t buffer[3];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint8_t);
+    init_cfg.num_elems = 3;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint8_t elem1 = 0xA1;
+    uint8_t elem2 = 0xA2;
+    uint8_t elem3 = 0xA3;
+    uint8_t elem4 = 0xA4;
+    uint8_t popped_elem;
+    push(&elem1);
+    push(&elem2);
+    push(&elem3);
+    pop(&popped_elem);
+    push(&elem4);
+    /* elem4 is in the first slot of the storage */
+
+    uint8_t peeked_elem = 0;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_peek(ring_buf, 2, &peeked_elem));
+    CHECK_EQUAL(elem4, peeked_elem);
+}
+
+TEST(RingBuf, PeekIndexOutOfRange)
+{
+    uint8_t buffer[3];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint8_t);
+    init_cfg.num_elems = 3;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint8_t peeked_elem;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_peek(ring_buf, 0, &peeked_elem));
+
+    uint8_t elem = 0x5A;
+    push(&elem);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_peek(ring_buf, 1, &peeked_elem));
+}
+
+TEST(RingBuf, PeekInvalArg)
+{
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint8_t elem = 1;
+    push(&elem);
+
+    uint8_t peeked_elem;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_peek(NULL, 0, &peeked_elem));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_peek(ring_buf, 0, NULL));
+}
+
+TEST(RingBuf, GetSpansEmpty)
+{
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_get_spans(ring_buf, &spans));
+    CHECK_EQUAL(0, spans.first_num_elems);
+    CHECK_EQUAL(0, spans.second_num_elems);
+    POINTERS_EQUAL(NULL, spans.first);
+    POINTERS_EQUAL(NULL, spans.second);
+}
+
+TEST(RingBuf, GetSpansContiguous)
+{
+    uint8_t buffer[4];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint8_t);
+    init_cfg.num_elems = 4;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint8_t elem1 = 0x01;
+    uint8_t elem2 = 0x02;
+    uint8_t elem3 = 0x03;
+    uint8_t popped_elem;
+    push(&elem1);
+    push(&elem2);
+    push(&elem3);
+    pop(&popped_elem);
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_get_spans(ring_buf, &spans));
+    CHECK_EQUAL(2, spans.first_num_elems);
+    POINTERS_EQUAL(&buffer[1], spans.first);
+    CHECK_EQUAL(0, spans.second_num_elems);
+    POINTERS_EQUAL(NULL, spans.second);
+}
+
+TEST(RingBuf, GetSpansWrapAround)
+{
+    uint16_t buffer[3];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint16_t);
+    init_cfg.num_elems = 3;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint16_t elem1 = 0x0101;
+    uint16_t elem2 = 0x0202;
+    uint16_t elem3 = 0x0303;
+    uint16_t elem4 = 0x0404;
+    uint16_t elem5 = 0x0505;
+    uint16_t popped_elem;
+    push(&elem1);
+    push(&elem2);
+    push(&elem3);
+    pop(&popped_elem);
+    pop(&popped_elem);
+    push(&elem4);
+    push(&elem5);
+    /* elem3 is in the last slot, elem4 and elem5 are in the first two slots */
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_get_spans(ring_buf, &spans));
+    CHECK_EQUAL(1, spans.first_num_elems);
+    POINTERS_EQUAL(&buffer[2], spans.first);
+    CHECK_EQUAL(2, spans.second_num_elems);
+    POINTERS_EQUAL(&buffer[0], spans.second);
+
+    const uint16_t *second = (const uint16_t *)spans.second;
+    CHECK_EQUAL(elem3, *(const uint16_t *)spans.first);
+    CHECK_EQUAL(elem4, second[0]);
+    CHECK_EQUAL(elem5, second[1]);
+}
+
+TEST(RingBuf, GetSpansInvalArg)
+{
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_spans(NULL, &spans));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_spans(ring_buf, NULL));
+}
+
+TEST(RingBuf, ResizeGrowKeepsElementsInOrder)
+{
+    uint16_t buffer[3];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint16_t);
+    init_cfg.num_elems = 3;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint16_t elem1 = 0x0101;
+    uint16_t elem2 = 0x0202;
+    uint16_t elem3 = 0x0303;
+    uint16_t elem4 = 0x0404;
+    uint16_t popped_elem;
+    push(&elem1);
+    push(&elem2);
+    push(&elem3);
+    pop(&popped_elem);
+    push(&elem4);
+    /* Buffer is full and wrapped around: elem2, elem3, elem4 */
+
+    uint16_t new_buffer[5];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_resize(ring_buf, new_buffer, 5));
+    CHECK_EQUAL(3, get_count());
+
+    /* There is now space for two more elements */
+    uint16_t elem5 = 0x0505;
+    uint16_t elem6 = 0x0606;
+    push(&elem5);
+    push(&elem6);
+    uint16_t unused = 0x0707;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_push(ring_buf, &unused));
+
+    const uint16_t expected[] = {elem2, elem3, elem4, elem5, elem6};
+    for (size_t i = 0; i < 5; i++) {
+        pop(&popped_elem);
+        CHECK_EQUAL(expected[i], popped_elem);
+    }
+}
+
+TEST(RingBuf, ResizeShrinkToCount)
+{
+    uint8_t buffer[4];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint8_t);
+    init_cfg.num_elems = 4;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint8_t elem1 = 0xA1;
+    uint8_t elem2 = 0xA2;
+    push(&elem1);
+    push(&elem2);
+
+    uint8_t new_buffer[2];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_resize(ring_buf, new_buffer, 2));
+
+    /* New buffer is full */
+    uint8_t unused = 0xA3;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_push(ring_buf, &unused));
+
+    uint8_t popped_elem;
+    pop(&popped_elem);
+    CHECK_EQUAL(elem1, popped_elem);
+    pop(&popped_elem);
+    CHECK_EQUAL(elem2, popped_elem);
+}
+
+TEST(RingBuf, ResizeFailsWhenTooSmall)
+{
+    uint8_t buffer[3];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint8_t);
+    init_cfg.num_elems = 3;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint8_t elem1 = 0xB1;
+    uint8_t elem2 = 0xB2;
+    push(&elem1);
+    push(&elem2);
+
+    uint8_t new_buffer[1];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_resize(ring_buf, new_buffer, 1));
+
+    /* Ring buffer is unchanged */
+    CHECK_EQUAL(2, get_count());
+    uint8_t popped_elem;
+    pop(&popped_elem);
+    CHECK_EQUAL(elem1, popped_elem);
+}
+
+TEST(RingBuf, ResizeInvalArg)
+{
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    uint8_t new_buffer[2];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize(NULL, new_buffer, 2));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize(ring_buf, NULL, 2));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize(ring_buf, new_buffer, 0));
+}
+
+#define RING_BUF_TEST_MAX_DRAIN_BATCHES 8
+#define RING_BUF_TEST_MAX_DRAINED_ELEMS 16
+
+/* Record of what drain_cb was called with */
+static size_t drain_batch_sizes[RING_BUF_TEST_MAX_DRAIN_BATCHES];
+static size_t drain_num_batches;
+static uint8_t drained_elems[RING_BUF_TEST_MAX_DRAINED_ELEMS];
+static size_t drain_num_elems;
+
+static void drain_cb(const void *elems, size_t num_elems, void *user_data)
+{
+    POINTERS_EQUAL(get_inst_buf_user_data, user_data);
+    CHECK(drain_num_batches < RING_BUF_TEST_MAX_DRAIN_BATCHES);
+    CHECK(drain_num_elems + num_elems <= RING_BUF_TEST_MAX_DRAINED_ELEMS);
+
+    drain_batch_sizes[drain_num_batches++] = num_elems;
+    memcpy(&drained_elems[drain_num_elems], elems, num_elems);
+    drain_num_elems += num_elems;
+}
+
+static void reset_drain_record()
+{
+    drain_num_batches = 0;
+    drain_num_elems = 0;
+}
+
+static void create_uint8_ring_buf(uint8_t *const buffer, size_t num_elems)
+{
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint8_t);
+    init_cfg.num_elems = num_elems;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+    reset_drain_record();
+}
+
+static RingBufDrainCfg make_drain_cfg(size_t max_batch, size_t min_batch, size_t max_wait)
+{
+    RingBufDrainCfg drain_cfg;
+    drain_cfg.max_batch = max_batch;
+    drain_cfg.min_batch = min_batch;
+    drain_cfg.max_wait = max_wait;
+    return drain_cfg;
+}
+
+static void push_uint8(uint8_t elem)
+{
+    push(&elem);
+}
+
+TEST(RingBuf, DrainSplitsIntoMaxBatch)
+{
+    uint8_t buffer[8];
+    create_uint8_ring_buf(buffer, 8);
+    for (uint8_t i = 0; i < 5; i++) {
+        push_uint8(i);
+    }
+
+    RingBufDrainCfg drain_cfg = make_drain_cfg(2, 1, 0);
+    size_t num_drained = 0;
+    uint8_t rc = ring_buf_drain(ring_buf, &drain_cfg, drain_cb, get_inst_buf_user_data, &num_drained);
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(5, num_drained);
+    CHECK_EQUAL(3, drain_num_batches);
+    CHECK_EQUAL(2, drain_batch_sizes[0]);
+    CHECK_EQUAL(2, drain_batch_sizes[1]);
+    CHECK_EQUAL(1, drain_batch_sizes[2]);
+    const uint8_t expected[] = {0, 1, 2, 3, 4};
+    MEMCMP_EQUAL(expected, drained_elems, sizeof(expected));
+    CHECK_EQUAL(0, get_count());
+}
+
+TEST(RingBuf, DrainBatchDoesNotWrapAround)
+{
+    uint8_t buffer[4];
+    create_uint8_ring_buf(buffer, 4);
+    uint8_t popped_elem;
+    push_uint8(0x10);
+    push_uint8(0x11);
+    push_uint8(0x12);
+    pop(&popped_elem);
+    pop(&popped_elem);
+    push_uint8(0x13);
+    push_uint8(0x14);
+    push_uint8(0x15);
+    /* Full: 0x12, 0x13 at the end of the storage, 0x14, 0x15 at the start */
+
+    RingBufDrainCfg drain_cfg = make_drain_cfg(16, 1, 0);
+    size_t num_drained = 0;
+    uint8_t rc = ring_buf_drain(ring_buf, &drain_cfg, drain_cb, get_inst_buf_user_data, &num_drained);
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(4, num_drained);
+    CHECK_EQUAL(2, drain_num_batches);
+    CHECK_EQUAL(2, drain_batch_sizes[0]);
+    CHECK_EQUAL(2, drain_batch_sizes[1]);
+    const uint8_t expected[] = {0x12, 0x13, 0x14, 0x15};
+    MEMCMP_EQUAL(expected, drained_elems, sizeof(expected));
+
+    /* Buffer is empty and usable again */
+    push_uint8(0x16);
+    CHECK_EQUAL(1, get_count());
+}
+
+TEST(RingBuf, DrainEmptyReturnsNoData)
+{
+    uint8_t buffer[2];
+    create_uint8_ring_buf(buffer, 2);
+
+    RingBufDrainCfg drain_cfg = make_drain_cfg(1, 1, 0);
+    size_t num_drained = 1;
+    uint8_t rc = ring_buf_drain(ring_buf, &drain_cfg, drain_cb, get_inst_buf_user_data, &num_drained);
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, rc);
+    CHECK_EQUAL(0, num_drained);
+    CHECK_EQUAL(0, drain_num_batches);
+}
+
+TEST(RingBuf, DrainWaitsForMinBatchUpToMaxWait)
+{
+    uint8_t buffer[8];
+    create_uint8_ring_buf(buffer, 8);
+    push_uint8(0x21);
+    push_uint8(0x22);
+
+    RingBufDrainCfg drain_cfg = make_drain_cfg(4, 4, 2);
+
+    /* Fewer than min_batch elements: the first max_wait calls are held back */
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_drain(ring_buf, &drain_cfg, drain_cb, NULL, NULL));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_drain(ring_buf, &drain_cfg, drain_cb, NULL, NULL));
+    CHECK_EQUAL(0, drain_num_batches);
+    CHECK_EQUAL(2, get_count());
+
+    /* Waited long enough - drain what is there */
+    size_t num_drained = 0;
+    uint8_t rc = ring_buf_drain(ring_buf, &drain_cfg, drain_cb, get_inst_buf_user_data, &num_drained);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(2, num_drained);
+}
+
+TEST(RingBuf, DrainStartsOnceMinBatchReached)
+{
+    uint8_t buffer[8];
+    create_uint8_ring_buf(buffer, 8);
+    push_uint8(0x31);
+
+    RingBufDrainCfg drain_cfg = make_drain_cfg(8, 2, 100);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_drain(ring_buf, &drain_cfg, drain_cb, NULL, NULL));
+
+    push_uint8(0x32);
+    size_t num_drained = 0;
+    uint8_t rc = ring_buf_drain(ring_buf, &drain_cfg, drain_cb, get_inst_buf_user_data, &num_drained);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+    CHECK_EQUAL(2, num_drained);
+    CHECK_EQUAL(1, drain_num_batches);
+}
+
+TEST(RingBuf, DrainInvalArg)
+{
+    uint8_t buffer[2];
+    create_uint8_ring_buf(buffer, 2);
+
+    RingBufDrainCfg drain_cfg = make_drain_cfg(1, 1, 0);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_drain(NULL, &drain_cfg, drain_cb, NULL, NULL));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_drain(ring_buf, NULL, drain_cb, NULL, NULL));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_drain(ring_buf, &drain_cfg, NULL, NULL, NULL));
+
+    drain_cfg.max_batch = 0;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_drain(ring_buf, &drain_cfg, drain_cb, NULL, NULL));
+
+    drain_cfg.max_batch = 1;
+    drain_cfg.min_batch = 0;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_drain(ring_buf, &drain_cfg, drain_cb, NULL, NULL));
+}
+
+/* Fake clock for latency tracing */
+static uint64_t current_time;
+
+static uint64_t get_timestamp(void *user_data)
+{
+    POINTERS_EQUAL(get_inst_buf_user_data, user_data);
+    return current_time;
+}
+
+static uint64_t timestamps[4];
+static RingBufLatencyHist latency_hist;
+
+static void create_traced_uint8_ring_buf(uint8_t *const buffer, size_t num_elems)
+{
+    CHECK(num_elems <= sizeof(timestamps) / sizeof(timestamps[0]));
+    current_time = 0;
+    init_cfg.get_timestamp = get_timestamp;
+    init_cfg.get_timestamp_user_data = get_inst_buf_user_data;
+    init_cfg.timestamps = timestamps;
+    init_cfg.latency_hist = &latency_hist;
+    create_uint8_ring_buf(buffer, num_elems);
+}
+
+static RingBufLatencyHist get_latency_hist()
+{
+    RingBufLatencyHist hist;
+    uint8_t rc = ring_buf_get_latency_hist(ring_buf, &hist);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+    return hist;
+}
+
+static uint64_t get_percentile(const RingBufLatencyHist *const hist, uint32_t permille)
+{
+    uint64_t value = 0;
+    uint8_t rc = ring_buf_latency_hist_get_percentile(hist, permille, &value);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+    return value;
+}
+
+TEST(RingBuf, PopRecordsResidencyTime)
+{
+    uint8_t buffer[2];
+    create_traced_uint8_ring_buf(buffer, 2);
+
+    current_time = 100;
+    push_uint8(0x01);
+    current_time = 103;
+    push_uint8(0x02);
+    current_time = 110;
+    uint8_t popped_elem;
+    pop(&popped_elem);
+    pop(&popped_elem);
+
+    RingBufLatencyHist hist = get_latency_hist();
+    CHECK_EQUAL(2, hist.total_count);
+    CHECK_EQUAL(10, hist.max);
+    CHECK_EQUAL(1, hist.counts[10]);
+    CHECK_EQUAL(1, hist.counts[7]);
+}
+
+TEST(RingBuf, DrainRecordsResidencyTime)
+{
+    uint8_t buffer[4];
+    create_traced_uint8_ring_buf(buffer, 4);
+
+    current_time = 1;
+    push_uint8(0x01);
+    push_uint8(0x02);
+    push_uint8(0x03);
+    current_time = 6;
+
+    RingBufDrainCfg drain_cfg = make_drain_cfg(2, 1, 0);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_drain(ring_buf, &drain_cfg, drain_cb, get_inst_buf_user_data, NULL));
+
+    RingBufLatencyHist hist = get_latency_hist();
+    CHECK_EQUAL(3, hist.total_count);
+    CHECK_EQUAL(3, hist.counts[5]);
+}
+
+/* Drain callback that takes 50 ticks to process a batch */
+static void slow_drain_cb(const void *elems, size_t num_elems, void *user_data)
+{
+    drain_cb(elems, num_elems, user_data);
+    current_time += 50;
+}
+
+TEST(RingBuf, DrainDoesNotCountCallbackTimeAsResidency)
+{
+    uint8_t buffer[4];
+    create_traced_uint8_ring_buf(buffer, 4);
+
+    current_time = 1;
+    push_uint8(0x01);
+    push_uint8(0x02);
+    current_time = 6;
+
+    RingBufDrainCfg drain_cfg = make_drain_cfg(1, 1, 0);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK,
+                ring_buf_drain(ring_buf, &drain_cfg, slow_drain_cb, get_inst_buf_user_data, NULL));
+
+    /* The second element was handed over after the first batch was processed */
+    RingBufLatencyHist hist = get_latency_hist();
+    CHECK_EQUAL(2, hist.total_count);
+    CHECK_EQUAL(1, hist.counts[5]);
+    CHECK_EQUAL(55, hist.max);
+}
+
+TEST(RingBuf, LatencyPercentiles)
+{
+    uint8_t buffer[1];
+    create_traced_uint8_ring_buf(buffer, 1);
+
+    /* 999 elements stay for 10 ticks, one stays for 1000 ticks */
+    uint8_t popped_elem;
+    for (uint32_t i = 0; i < 1000; i++) {
+        push_uint8(0x42);
+        current_time += (i == 500) ? 1000 : 10;
+        pop(&popped_elem);
+    }
+
+    RingBufLatencyHist hist = get_latency_hist();
+    CHECK_EQUAL(1000, hist.total_count);
+    CHECK_EQUAL(10, get_percentile(&hist, 500));
+    CHECK_EQUAL(10, get_percentile(&hist, 990));
+    CHECK_EQUAL(10, get_percentile(&hist, 999));
+    /* Clamped to the largest recorded value */
+    CHECK_EQUAL(1000, get_percentile(&hist, 1000));
+}
+
+TEST(RingBuf, LatencyPercentileLargeValueWithinBucketPrecision)
+{
+    uint8_t buffer[1];
+    create_traced_uint8_ring_buf(buffer, 1);
+
+    uint8_t popped_elem;
+    push_uint8(0x42);
+    current_time = 1000000;
+    pop(&popped_elem);
+    push_uint8(0x42);
+    current_time += 900000;
+    pop(&popped_elem);
+
+    RingBufLatencyHist hist = get_latency_hist();
+    uint64_t p50 = get_percentile(&hist, 500);
+    CHECK(p50 >= 900000);
+    CHECK(p50 <= 900000 + (900000 / 8));
+}
+
+TEST(RingBuf, LatencyHistNotEnabled)
+{
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    RingBufLatencyHist hist;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_get_latency_hist(ring_buf, &hist));
+}
+
+TEST(RingBuf, LatencyPercentileEmptyHist)
+{
+    uint8_t buffer[1];
+    create_traced_uint8_ring_buf(buffer, 1);
+
+    RingBufLatencyHist hist = get_latency_hist();
+    uint64_t value;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_latency_hist_get_percentile(&hist, 500, &value));
+}
+
+TEST(RingBuf, LatencyInvalArg)
+{
+    uint8_t buffer[1];
+    create_traced_uint8_ring_buf(buffer, 1);
+
+    RingBufLatencyHist hist = get_latency_hist();
+    uint64_t value;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_latency_hist(NULL, &hist));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_latency_hist(ring_buf, NULL));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_latency_hist_get_percentile(NULL, 500, &value));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_latency_hist_get_percentile(&hist, 500, NULL));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_latency_hist_get_percentile(&hist, 1001, &value));
+}
+
+TEST(RingBuf, ResizeFailsWithLatencyTracing)
+{
+    uint8_t buffer[1];
+    create_traced_uint8_ring_buf(buffer, 1);
+
+    uint8_t new_buffer[2];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize(ring_buf, new_buffer, 2));
+}
+
+TEST(RingBuf, ResizeTracedMovesTimestamps)
+{
+    uint8_t buffer[3];
+    create_traced_uint8_ring_buf(buffer, 3);
+
+    /* Wrap around, so that the timestamps need to be linearized along with the elements */
+    uint8_t popped_elem;
+    push_uint8(0x01);
+    pop(&popped_elem);
+    current_time = 10;
+    push_uint8(0x02);
+    current_time = 20;
+    push_uint8(0x03);
+    current_time = 30;
+    push_uint8(0x04);
+
+    uint8_t new_buffer[4];
+    uint64_t new_timestamps[4];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_resize_traced(ring_buf, new_buffer, new_timestamps, 4));
+
+    current_time = 40;
+    push_uint8(0x05);
+    const uint64_t expected_timestamps[] = {10, 20, 30, 40};
+    MEMCMP_EQUAL(expected_timestamps, new_timestamps, sizeof(expected_timestamps));
+
+    current_time = 100;
+    for (uint8_t expected = 0x02; expected <= 0x05; expected++) {
+        pop(&popped_elem);
+        CHECK_EQUAL(expected, popped_elem);
+    }
+
+    /* Oldest element was pushed before the resize */
+    RingBufLatencyHist hist = get_latency_hist();
+    CHECK_EQUAL(5, hist.total_count);
+    CHECK_EQUAL(90, hist.max);
+}
+
+TEST(RingBuf, ResizeTracedFailsWithoutLatencyTracing)
+{
+    uint8_t buffer[1];
+    create_uint8_ring_buf(buffer, 1);
+
+    uint8_t new_buffer[2];
+    uint64_t new_timestamps[2];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize_traced(ring_buf, new_buffer, new_timestamps, 2));
+}
+
+TEST(RingBuf, ResizeTracedInvalArg)
+{
+    uint8_t buffer[1];
+    create_traced_uint8_ring_buf(buffer, 1);
+
+    uint8_t new_buffer[2];
+    uint64_t new_timestamps[2];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize_traced(NULL, new_buffer, new_timestamps, 2));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize_traced(ring_buf, NULL, new_timestamps, 2));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize_traced(ring_buf, new_buffer, NULL, 2));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_resize_traced(ring_buf, new_buffer, new_timestamps, 0));
+}
+
+typedef struct {
+    uint32_t timestamp;
+    uint16_t value;
+    uint16_t id;
+} SoaElem;
+
+static const size_t soa_field_sizes[] = {sizeof(uint32_t), sizeof(uint16_t), sizeof(uint16_t)};
+#define SOA_NUM_FIELDS (sizeof(soa_field_sizes) / sizeof(soa_field_sizes[0]))
+#define SOA_FIELD_TIMESTAMP 0
+#define SOA_FIELD_VALUE 1
+#define SOA_BUFFER_SIZE(num_elems)                                                                                     \
+    (RING_BUF_SOA_COLUMN_SIZE(num_elems, sizeof(uint32_t)) + 2 * RING_BUF_SOA_COLUMN_SIZE(num_elems, sizeof(uint16_t)))
+
+static void create_soa_ring_buf(void *buffer, size_t num_elems)
+{
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(SoaElem);
+    init_cfg.num_elems = num_elems;
+    init_cfg.field_sizes = soa_field_sizes;
+    init_cfg.num_fields = SOA_NUM_FIELDS;
+
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+}
+
+static SoaElem make_soa_elem(uint32_t i)
+{
+    SoaElem elem;
+    elem.timestamp = 0x10000000 + i;
+    elem.value = (uint16_t)(0x2000 + i);
+    elem.id = (uint16_t)(0x3000 + i);
+    return elem;
+}
+
+static void push_soa_elem(uint32_t i)
+{
+    SoaElem elem = make_soa_elem(i);
+    push(&elem);
+}
+
+static void check_pop_soa_elem(uint32_t i)
+{
+    SoaElem expected = make_soa_elem(i);
+    SoaElem popped_elem;
+    pop(&popped_elem);
+    CHECK_EQUAL(expected.timestamp, popped_elem.timestamp);
+    CHECK_EQUAL(expected.value, popped_elem.value);
+    CHECK_EQUAL(expected.id, popped_elem.id);
+}
+
+TEST(RingBuf, SoaPushPopWrapAround)
+{
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t buffer[SOA_BUFFER_SIZE(3)];
+    create_soa_ring_buf(buffer, 3);
+
+    push_soa_elem(0);
+    push_soa_elem(1);
+    push_soa_elem(2);
+    check_pop_soa_elem(0);
+    check_pop_soa_elem(1);
+    push_soa_elem(3);
+    push_soa_elem(4);
+    check_pop_soa_elem(2);
+    check_pop_soa_elem(3);
+    check_pop_soa_elem(4);
+}
+
+TEST(RingBuf, SoaStoresEachFieldInItsOwnColumn)
+{
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t buffer[SOA_BUFFER_SIZE(2)];
+    create_soa_ring_buf(buffer, 2);
+
+    push_soa_elem(0);
+    push_soa_elem(1);
+
+    /* Two timestamps, then two values in the next column, then two ids */
+    uint32_t timestamps[2];
+    uint16_t values[2];
+    memcpy(timestamps, buffer, sizeof(timestamps));
+    memcpy(values, buffer + RING_BUF_SOA_COLUMN_SIZE(2, sizeof(uint32_t)), sizeof(values));
+    CHECK_EQUAL(make_soa_elem(0).timestamp, timestamps[0]);
+    CHECK_EQUAL(make_soa_elem(1).timestamp, timestamps[1]);
+    CHECK_EQUAL(make_soa_elem(0).value, values[0]);
+    CHECK_EQUAL(make_soa_elem(1).value, values[1]);
+}
+
+TEST(RingBuf, SoaPeek)
+{
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t buffer[SOA_BUFFER_SIZE(3)];
+    create_soa_ring_buf(buffer, 3);
+
+    push_soa_elem(0);
+    push_soa_elem(1);
+
+    SoaElem peeked_elem;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_peek(ring_buf, 1, &peeked_elem));
+    CHECK_EQUAL(make_soa_elem(1).timestamp, peeked_elem.timestamp);
+    CHECK_EQUAL(make_soa_elem(1).id, peeked_elem.id);
+}
+
+TEST(RingBuf, SoaColumnSpansWrapAround)
+{
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t buffer[SOA_BUFFER_SIZE(4)];
+    create_soa_ring_buf(buffer, 4);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        push_soa_elem(i);
+    }
+    check_pop_soa_elem(0);
+    check_pop_soa_elem(1);
+    check_pop_soa_elem(2);
+    push_soa_elem(4);
+    push_soa_elem(5);
+    /* Elements 3, 4, 5: element 3 in the last slot, 4 and 5 in the first two slots */
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_get_column_spans(ring_buf, SOA_FIELD_VALUE, &spans));
+    CHECK_EQUAL(1, spans.first_num_elems);
+    CHECK_EQUAL(2, spans.second_num_elems);
+
+    uint16_t value;
+    memcpy(&value, spans.first, sizeof(value));
+    CHECK_EQUAL(make_soa_elem(3).value, value);
+    memcpy(&value, (const uint8_t *)spans.second + sizeof(uint16_t), sizeof(value));
+    CHECK_EQUAL(make_soa_elem(5).value, value);
+
+    /* Value column follows the padded timestamp column of 4 values */
+    POINTERS_EQUAL(buffer + RING_BUF_SOA_COLUMN_SIZE(4, sizeof(uint32_t)), spans.second);
+}
+
+TEST(RingBuf, SoaResizeKeepsElements)
+{
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t buffer[SOA_BUFFER_SIZE(3)];
+    create_soa_ring_buf(buffer, 3);
+
+    push_soa_elem(0);
+    push_soa_elem(1);
+    push_soa_elem(2);
+    check_pop_soa_elem(0);
+    push_soa_elem(3);
+    /* Full and wrapped around: 1, 2, 3 */
+
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t new_buffer[SOA_BUFFER_SIZE(5)];
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_resize(ring_buf, new_buffer, 5));
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_get_column_spans(ring_buf, SOA_FIELD_TIMESTAMP, &spans));
+    CHECK_EQUAL(3, spans.first_num_elems);
+    POINTERS_EQUAL(new_buffer, spans.first);
+
+    push_soa_elem(4);
+    for (uint32_t i = 1; i <= 4; i++) {
+        check_pop_soa_elem(i);
+    }
+}
+
+TEST(RingBuf, SoaColumnsAreAligned)
+{
+    /* 3 values of the 2-byte field would leave the 4-byte column misaligned without padding */
+    static const size_t field_sizes[] = {sizeof(uint16_t), sizeof(uint32_t)};
+    const size_t num_elems = 3;
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t
+        buffer[RING_BUF_SOA_COLUMN_SIZE(3, sizeof(uint16_t)) + RING_BUF_SOA_COLUMN_SIZE(3, sizeof(uint32_t))];
+    init_cfg.buffer = buffer;
+    init_cfg.elem_size = sizeof(uint16_t) + sizeof(uint32_t);
+    init_cfg.num_elems = num_elems;
+    init_cfg.field_sizes = field_sizes;
+    init_cfg.num_fields = 2;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_create(&ring_buf, &init_cfg));
+
+    uint8_t elem[sizeof(uint16_t) + sizeof(uint32_t)];
+    for (uint8_t i = 0; i < num_elems; i++) {
+        memset(elem, i + 1, sizeof(elem));
+        CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_push(ring_buf, elem));
+    }
+
+    for (size_t field_idx = 0; field_idx < 2; field_idx++) {
+        RingBufSpans spans;
+        CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_get_column_spans(ring_buf, field_idx, &spans));
+        CHECK_EQUAL(num_elems, spans.first_num_elems);
+        CHECK_EQUAL(0, (uintptr_t)spans.first % RING_BUF_SOA_COLUMN_ALIGN);
+    }
+
+    uint8_t popped_elem[sizeof(elem)];
+    for (uint8_t i = 0; i < num_elems; i++) {
+        memset(elem, i + 1, sizeof(elem));
+        pop(popped_elem);
+        MEMCMP_EQUAL(elem, popped_elem, sizeof(elem));
+    }
+}
+
+TEST(RingBuf, SoaGetSpansAndDrainNotSupported)
+{
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t buffer[SOA_BUFFER_SIZE(2)];
+    create_soa_ring_buf(buffer, 2);
+    push_soa_elem(0);
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_spans(ring_buf, &spans));
+    RingBufDrainCfg drain_cfg = make_drain_cfg(1, 1, 0);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_drain(ring_buf, &drain_cfg, drain_cb, NULL, NULL));
+}
+
+TEST(RingBuf, GetColumnSpansInvalArg)
+{
+    alignas(RING_BUF_SOA_COLUMN_ALIGN) uint8_t buffer[SOA_BUFFER_SIZE(2)];
+    create_soa_ring_buf(buffer, 2);
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_column_spans(NULL, 0, &spans));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_column_spans(ring_buf, 0, NULL));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_column_spans(ring_buf, SOA_NUM_FIELDS, &spans));
+}
+
+TEST(RingBuf, GetColumnSpansWithoutSchema)
+{
+    uint8_t create_rc = ring_buf_create(&ring_buf, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, create_rc);
+
+    RingBufSpans spans;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_get_column_spans(ring_buf, 0, &spans));
+}
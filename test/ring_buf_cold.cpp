@@ -0,0 +1,246 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "ring_buf_cold.h"
+/* Included to know the size of RingBufCold instance to return from mock_ring_buf_get_inst_buf. */
+#include "ring_buf_cold_private.h"
+#include "mock_cfg_functions.h"
+
+/* To return from mock_ring_buf_get_inst_buf */
+static struct RingBufColdStruct inst_buf;
+
+static RingBufCold cold;
+static RingBufColdInitCfg init_cfg;
+
+static void *get_inst_buf_user_data = (void *)0x40;
+
+typedef struct {
+    uint32_t timestamp;
+    uint16_t value;
+    uint8_t flags;
+    uint8_t id;
+} Record;
+
+/* Room for 3 worst-case records per block */
+#define RING_BUF_COLD_TEST_BLOCK_SIZE                                                                                  \
+    (RING_BUF_COLD_BLOCK_HEADER_SIZE + 3 * RING_BUF_COLD_MAX_ENCODED_SIZE(sizeof(Record)))
+#define RING_BUF_COLD_TEST_NUM_BLOCKS 2
+static uint8_t default_buffer[RING_BUF_COLD_TEST_NUM_BLOCKS * RING_BUF_COLD_TEST_BLOCK_SIZE];
+static Record prev_elem;
+
+static void populate_default_init_cfg(RingBufColdInitCfg *const cfg)
+{
+    cfg->get_inst_buf = mock_ring_buf_get_inst_buf;
+    cfg->get_inst_buf_user_data = get_inst_buf_user_data;
+    cfg->elem_size = sizeof(Record);
+    cfg->block_size = RING_BUF_COLD_TEST_BLOCK_SIZE;
+    cfg->num_blocks = RING_BUF_COLD_TEST_NUM_BLOCKS;
+    cfg->buffer = default_buffer;
+    cfg->prev_elem = &prev_elem;
+}
+
+// clang-format off
+TEST_GROUP(RingBufCold){
+    void setup() {
+        cold = NULL;
+        memset(&init_cfg, 0, sizeof(RingBufColdInitCfg));
+        memset(&inst_buf, 0, sizeof(struct RingBufColdStruct));
+
+        populate_default_init_cfg(&init_cfg);
+    }
+};
+// clang-format on
+
+static void create()
+{
+    mock()
+        .expectOneCall("mock_ring_buf_get_inst_buf")
+        .withParameter("user_data", get_inst_buf_user_data)
+        .andReturnValue((void *)&inst_buf);
+
+    uint8_t rc = ring_buf_cold_create(&cold, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+}
+
+static void append(const Record *const record)
+{
+    uint8_t rc = ring_buf_cold_append(cold, record);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, rc);
+}
+
+static Record make_record(uint32_t i)
+{
+    Record record;
+    memset(&record, 0, sizeof(Record));
+    record.timestamp = 1000 + i;
+    record.value = (uint16_t)(0x4000 + (i / 2));
+    record.flags = 0x01;
+    record.id = 7;
+    return record;
+}
+
+TEST(RingBufCold, CreateReturnsBufReturnedFromGetInstBuf)
+{
+    create();
+    CHECK_EQUAL((void *)&inst_buf, (void *)cold);
+}
+
+TEST(RingBufCold, CreateReturnsInvalArgBlockTooSmall)
+{
+    init_cfg.block_size = RING_BUF_COLD_MIN_BLOCK_SIZE(sizeof(Record)) - 1;
+    uint8_t rc = ring_buf_cold_create(&cold, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, rc);
+}
+
+TEST(RingBufCold, CreateReturnsInvalArgPrevElemNull)
+{
+    init_cfg.prev_elem = NULL;
+    uint8_t rc = ring_buf_cold_create(&cold, &init_cfg);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, rc);
+}
+
+TEST(RingBufCold, IterEmpty)
+{
+    create();
+
+    RingBufColdIter iter;
+    Record record;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_init(cold, &iter));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_cold_iter_next(cold, &iter, &record));
+}
+
+TEST(RingBufCold, AppendIterRoundTrip)
+{
+    /* Slowly changing records compress well: 8 records fit into space for 6 worst-case ones */
+    init_cfg.block_size = sizeof(default_buffer);
+    init_cfg.num_blocks = 1;
+    create();
+
+    const uint32_t num_records = 8;
+    for (uint32_t i = 0; i < num_records; i++) {
+        Record record = make_record(i);
+        append(&record);
+    }
+
+    RingBufColdIter iter;
+    Record decoded;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_init(cold, &iter));
+    for (uint32_t i = 0; i < num_records; i++) {
+        CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_next(cold, &iter, &decoded));
+        Record expected = make_record(i);
+        MEMCMP_EQUAL(&expected, &decoded, sizeof(Record));
+    }
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_cold_iter_next(cold, &iter, &decoded));
+}
+
+TEST(RingBufCold, SlowlyChangingRecordsCompressAtLeastThreeAndHalfTimes)
+{
+    /* Only the timestamp changes with every record and the value with every other one. Consecutive records share
+     * one bitmap, so all of them must fit into a single block of 1/3.5 of their raw size. */
+    const uint32_t num_records = 64;
+    uint8_t buffer[RING_BUF_COLD_BLOCK_HEADER_SIZE + (num_records * sizeof(Record) * 2) / 7];
+    init_cfg.block_size = sizeof(buffer);
+    init_cfg.num_blocks = 1;
+    init_cfg.buffer = buffer;
+    create();
+
+    for (uint32_t i = 0; i < num_records; i++) {
+        Record record = make_record(i);
+        append(&record);
+    }
+
+    /* Nothing was discarded */
+    RingBufColdIter iter;
+    Record decoded;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_init(cold, &iter));
+    for (uint32_t i = 0; i < num_records; i++) {
+        CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_next(cold, &iter, &decoded));
+        Record expected = make_record(i);
+        MEMCMP_EQUAL(&expected, &decoded, sizeof(Record));
+    }
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_cold_iter_next(cold, &iter, &decoded));
+}
+
+TEST(RingBufCold, OldestBlockIsDiscardedWhenFull)
+{
+    create();
+
+    /* Records that differ from each other in every byte, so each takes the worst-case size: 3 per block */
+    const uint8_t num_records = 8;
+    for (uint8_t i = 0; i < num_records; i++) {
+        Record record;
+        memset(&record, (i % 2) ? 0xFF : 0x11 * (i + 1), sizeof(Record));
+        append(&record);
+    }
+
+    /* Records 0-2 were in the first block, which was reused for records 6 and 7 */
+    RingBufColdIter iter;
+    Record decoded;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_init(cold, &iter));
+    for (uint8_t i = 3; i < num_records; i++) {
+        CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_next(cold, &iter, &decoded));
+        Record expected;
+        memset(&expected, (i % 2) ? 0xFF : 0x11 * (i + 1), sizeof(Record));
+        MEMCMP_EQUAL(&expected, &decoded, sizeof(Record));
+    }
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_cold_iter_next(cold, &iter, &decoded));
+}
+
+TEST(RingBufCold, UnchangedRecordsRoundTrip)
+{
+    /* Identical records take no bytes after the first one of a group. Runs of them end the first block and are the
+     * last records appended. */
+    const uint32_t num_records = 12;
+    /* First block ends right after the run of record 2: 7 + 2 + 3 + 4 + 2 encoded bytes */
+    init_cfg.block_size = RING_BUF_COLD_BLOCK_HEADER_SIZE + 18;
+    create();
+
+    const uint32_t record_idx[num_records] = {0, 0, 0, 1, 2, 2, 2, 2, 3, 4, 4, 4};
+    for (uint32_t i = 0; i < num_records; i++) {
+        Record record = make_record(record_idx[i]);
+        append(&record);
+    }
+
+    RingBufColdIter iter;
+    Record decoded;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_init(cold, &iter));
+    for (uint32_t i = 0; i < num_records; i++) {
+        CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_next(cold, &iter, &decoded));
+        Record expected = make_record(record_idx[i]);
+        MEMCMP_EQUAL(&expected, &decoded, sizeof(Record));
+    }
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_cold_iter_next(cold, &iter, &decoded));
+}
+
+TEST(RingBufCold, AllZeroRecordsRoundTrip)
+{
+    /* Every record equals the all-zero element that a block starts from, so all of them are stored in 0 bytes */
+    create();
+
+    const uint32_t num_records = 5;
+    Record record;
+    memset(&record, 0, sizeof(Record));
+    for (uint32_t i = 0; i < num_records; i++) {
+        append(&record);
+    }
+
+    RingBufColdIter iter;
+    Record decoded;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_init(cold, &iter));
+    for (uint32_t i = 0; i < num_records; i++) {
+        CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_cold_iter_next(cold, &iter, &decoded));
+        MEMCMP_EQUAL(&record, &decoded, sizeof(Record));
+    }
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, ring_buf_cold_iter_next(cold, &iter, &decoded));
+}
+
+TEST(RingBufCold, AppendNullArgs)
+{
+    create();
+
+    Record record = make_record(0);
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_cold_append(NULL, &record));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_cold_append(cold, NULL));
+}
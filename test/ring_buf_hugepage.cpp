@@ -0,0 +1,122 @@
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "ring_buf.h"
+#include "ring_buf_hugepage.h"
+
+static RingBufHugepageCfg hugepage_cfg;
+static RingBufHugepageAlloc alloc;
+
+// clang-format off
+TEST_GROUP(RingBufHugepage){
+    void setup() {
+        memset(&alloc, 0, sizeof(RingBufHugepageAlloc));
+        memset(&hugepage_cfg, 0, sizeof(RingBufHugepageCfg));
+        hugepage_cfg.elem_size = sizeof(uint32_t);
+        hugepage_cfg.num_elems = 1024;
+        hugepage_cfg.numa_node = RING_BUF_HUGEPAGE_NO_NUMA_NODE;
+    }
+
+    void teardown() {
+        if (alloc.map) {
+            ring_buf_hugepage_free(&alloc);
+        }
+    }
+};
+// clang-format on
+
+TEST(RingBufHugepage, AllocMapsWholeHugePages)
+{
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+
+    CHECK(alloc.map != NULL);
+    CHECK_EQUAL(0, alloc.map_size % RING_BUF_HUGEPAGE_SIZE);
+    CHECK((uint8_t *)alloc.buffer + (hugepage_cfg.num_elems * hugepage_cfg.elem_size) <=
+          (uint8_t *)alloc.map + alloc.map_size);
+}
+
+TEST(RingBufHugepage, CreatedRingBufIsUsable)
+{
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+
+    RingBufInitCfg init_cfg;
+    memset(&init_cfg, 0, sizeof(RingBufInitCfg));
+    init_cfg.get_inst_buf = ring_buf_hugepage_get_inst_buf;
+    init_cfg.get_inst_buf_user_data = &alloc;
+    init_cfg.elem_size = hugepage_cfg.elem_size;
+    init_cfg.num_elems = hugepage_cfg.num_elems;
+    init_cfg.buffer = alloc.buffer;
+
+    RingBuf ring_buf;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_create(&ring_buf, &init_cfg));
+    POINTERS_EQUAL(alloc.inst_buf, ring_buf);
+
+    uint32_t elem = 0xDEADBEEF;
+    uint32_t popped_elem = 0;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_push(ring_buf, &elem));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_pop(ring_buf, &popped_elem));
+    CHECK_EQUAL(elem, popped_elem);
+}
+
+TEST(RingBufHugepage, AllocSizesStorageForSoaLayout)
+{
+    /* With the instance taking the first 128 bytes, num_elems * elem_size fits into one huge page, but the column
+     * padding does not */
+    static const size_t field_sizes[] = {sizeof(uint8_t), sizeof(uint16_t), sizeof(uint32_t)};
+    hugepage_cfg.elem_size = sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint32_t);
+    hugepage_cfg.num_elems = (RING_BUF_HUGEPAGE_SIZE - 128) / hugepage_cfg.elem_size;
+    hugepage_cfg.field_sizes = field_sizes;
+    hugepage_cfg.num_fields = 3;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+
+    size_t storage_size = 0;
+    for (size_t i = 0; i < hugepage_cfg.num_fields; i++) {
+        storage_size += RING_BUF_SOA_COLUMN_SIZE(hugepage_cfg.num_elems, field_sizes[i]);
+    }
+    CHECK_EQUAL(0, (uintptr_t)alloc.buffer % RING_BUF_SOA_COLUMN_ALIGN);
+    CHECK((uint8_t *)alloc.buffer + storage_size <= (uint8_t *)alloc.map + alloc.map_size);
+}
+
+TEST(RingBufHugepage, GetInstBufReturnsInstOnlyOnce)
+{
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+
+    POINTERS_EQUAL(alloc.inst_buf, ring_buf_hugepage_get_inst_buf(&alloc));
+    POINTERS_EQUAL(NULL, ring_buf_hugepage_get_inst_buf(&alloc));
+}
+
+TEST(RingBufHugepage, AllocWithNumaNodeSucceeds)
+{
+    /* Node 0 always exists. Binding may fail without kernel NUMA support, allocation must succeed regardless. */
+    hugepage_cfg.numa_node = 0;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+}
+
+TEST(RingBufHugepage, AllocInvalArg)
+{
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_hugepage_alloc(NULL, &hugepage_cfg));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_hugepage_alloc(&alloc, NULL));
+
+    hugepage_cfg.elem_size = 0;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+
+    hugepage_cfg.elem_size = sizeof(uint32_t);
+    hugepage_cfg.numa_node = -2;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+
+    /* Field sizes do not add up to elem_size */
+    static const size_t field_sizes[] = {sizeof(uint16_t), sizeof(uint16_t), sizeof(uint16_t)};
+    hugepage_cfg.numa_node = RING_BUF_HUGEPAGE_NO_NUMA_NODE;
+    hugepage_cfg.field_sizes = field_sizes;
+    hugepage_cfg.num_fields = 3;
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+}
+
+TEST(RingBufHugepage, FreeTwiceReturnsInvalArg)
+{
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_hugepage_alloc(&alloc, &hugepage_cfg));
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_hugepage_free(&alloc));
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, ring_buf_hugepage_free(&alloc));
+}
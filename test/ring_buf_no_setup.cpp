@@ -97,3 +97,61 @@ TEST(RingBufNoSetup, CreateGetInstBufReturnsNull)
 
     CHECK_EQUAL(RING_BUF_RESULT_CODE_NO_DATA, rc);
 }
+
+static uint64_t get_timestamp(void *user_data)
+{
+    (void)user_data;
+    return 0;
+}
+
+TEST(RingBufNoSetup, CreateTimestampsNullWithLatencyTracing)
+{
+    RingBufLatencyHist latency_hist;
+    init_cfg.get_timestamp = get_timestamp;
+    init_cfg.latency_hist = &latency_hist;
+    init_cfg.timestamps = NULL;
+    uint8_t rc = ring_buf_create(&ring_buf, &init_cfg);
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, rc);
+}
+
+TEST(RingBufNoSetup, CreateLatencyHistNullWithLatencyTracing)
+{
+    uint64_t timestamps[RING_BUF_TEST_DEFAULT_NUM_ELEMS];
+    init_cfg.get_timestamp = get_timestamp;
+    init_cfg.timestamps = timestamps;
+    init_cfg.latency_hist = NULL;
+    uint8_t rc = ring_buf_create(&ring_buf, &init_cfg);
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, rc);
+}
+
+TEST(RingBufNoSetup, CreateFieldSizesDoNotAddUpToElemSize)
+{
+    const size_t field_sizes[] = {1, 1};
+    init_cfg.field_sizes = field_sizes;
+    init_cfg.num_fields = 2;
+    uint8_t rc = ring_buf_create(&ring_buf, &init_cfg);
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, rc);
+}
+
+TEST(RingBufNoSetup, CreateFieldSize0)
+{
+    const size_t field_sizes[] = {sizeof(uint8_t), 0};
+    init_cfg.field_sizes = field_sizes;
+    init_cfg.num_fields = 2;
+    uint8_t rc = ring_buf_create(&ring_buf, &init_cfg);
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, rc);
+}
+
+TEST(RingBufNoSetup, CreateNumFields0)
+{
+    const size_t field_sizes[] = {sizeof(uint8_t)};
+    init_cfg.field_sizes = field_sizes;
+    init_cfg.num_fields = 0;
+    uint8_t rc = ring_buf_create(&ring_buf, &init_cfg);
+
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_INVAL_ARG, rc);
+}
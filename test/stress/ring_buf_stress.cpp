@@ -0,0 +1,242 @@
+/* Standard headers must come before CppUTest headers, which redefine operator new for leak detection. */
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+
+#include "ring_buf.h"
+/* Included to know the size of RingBuf instance to return from get_inst_buf. */
+#include "ring_buf_private.h"
+
+/**
+ * Multithreaded stress tests.
+ *
+ * Producers push sequence-tagged elements and consumers pop them. Threads randomly yield or spin between operations
+ * to vary the schedule. Delay patterns are seeded per test, the interleaving itself is up to the OS scheduler. After
+ * all threads finish, the tests check that:
+ * - every pushed element was popped exactly once (no loss, no duplication),
+ * - every consumer observed the elements of each producer in the order they were pushed (per-producer FIFO).
+ *
+ * RingBuf is not thread-safe, so the access functions below serialize calls with a mutex. This is the way the
+ * application is expected to share an instance between threads. A concurrent RingBuf mode can be verified by
+ * providing StressOps that call it without the lock.
+ */
+
+typedef struct {
+    uint32_t producer;
+    uint32_t seq;
+} StressElem;
+
+typedef struct {
+    RingBuf ring_buf;
+    std::mutex lock;
+} StressCtx;
+
+/** Functions that producers and consumers use to access the ring buffer. */
+typedef struct {
+    uint8_t (*push)(StressCtx *ctx, const StressElem *elem);
+    /** Pops up to max_elems elements into elems, writes the number of popped elements to num_popped. elems has room
+     * for as many elements as the ring buffer capacity. */
+    uint8_t (*pop)(StressCtx *ctx, StressElem *elems, size_t max_elems, size_t *num_popped);
+} StressOps;
+
+typedef struct {
+    size_t num_producers;
+    size_t num_consumers;
+    uint32_t elems_per_producer;
+    size_t capacity;
+    uint32_t seed;
+} StressCfg;
+
+static struct RingBufStruct inst_buf;
+
+static void *get_inst_buf(void *user_data)
+{
+    (void)user_data;
+    return &inst_buf;
+}
+
+static uint8_t locked_push(StressCtx *ctx, const StressElem *elem)
+{
+    std::lock_guard<std::mutex> guard(ctx->lock);
+    return ring_buf_push(ctx->ring_buf, elem);
+}
+
+static uint8_t locked_pop(StressCtx *ctx, StressElem *elems, size_t max_elems, size_t *num_popped)
+{
+    (void)max_elems;
+    std::lock_guard<std::mutex> guard(ctx->lock);
+    uint8_t rc = ring_buf_pop(ctx->ring_buf, elems);
+    *num_popped = (rc == RING_BUF_RESULT_CODE_OK) ? 1 : 0;
+    return rc;
+}
+
+typedef struct {
+    StressElem *elems;
+    size_t num_elems;
+} DrainDest;
+
+static void copy_drained(const void *elems, size_t num_elems, void *user_data)
+{
+    DrainDest *dest = (DrainDest *)user_data;
+    memcpy(dest->elems + dest->num_elems, elems, num_elems * sizeof(StressElem));
+    dest->num_elems += num_elems;
+}
+
+static uint8_t locked_drain(StressCtx *ctx, StressElem *elems, size_t max_elems, size_t *num_popped)
+{
+    RingBufDrainCfg drain_cfg;
+    drain_cfg.max_batch = max_elems;
+    drain_cfg.min_batch = 1;
+    drain_cfg.max_wait = 0;
+    DrainDest dest = {elems, 0};
+
+    std::lock_guard<std::mutex> guard(ctx->lock);
+    return ring_buf_drain(ctx->ring_buf, &drain_cfg, copy_drained, &dest, num_popped);
+}
+
+static const StressOps locked_pop_ops = {locked_push, locked_pop};
+static const StressOps locked_drain_ops = {locked_push, locked_drain};
+
+/** Randomly yield to make thread interleavings differ between operations and runs. */
+static void random_delay(std::minstd_rand &rng)
+{
+    switch (rng() % 8) {
+    case 0:
+        std::this_thread::yield();
+        break;
+    case 1:
+        for (volatile int i = 0; i < 64; i++) {
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void run_stress(const StressCfg *cfg, const StressOps *ops)
+{
+    std::vector<StressElem> storage(cfg->capacity);
+    StressCtx ctx;
+    RingBufInitCfg init_cfg;
+    memset(&init_cfg, 0, sizeof(RingBufInitCfg));
+    init_cfg.get_inst_buf = get_inst_buf;
+    init_cfg.elem_size = sizeof(StressElem);
+    init_cfg.num_elems = cfg->capacity;
+    init_cfg.buffer = storage.data();
+    CHECK_EQUAL(RING_BUF_RESULT_CODE_OK, ring_buf_create(&ctx.ring_buf, &init_cfg));
+
+    const size_t total = cfg->num_producers * cfg->elems_per_producer;
+    std::atomic<size_t> num_consumed(0);
+    std::vector<std::vector<StressElem>> consumed(cfg->num_consumers);
+    std::vector<std::thread> threads;
+
+    for (size_t p = 0; p < cfg->num_producers; p++) {
+        threads.emplace_back([&, p]() {
+            std::minstd_rand rng(cfg->seed + (uint32_t)p);
+            for (uint32_t seq = 0; seq < cfg->elems_per_producer; seq++) {
+                StressElem elem = {(uint32_t)p, seq};
+                while (ops->push(&ctx, &elem) != RING_BUF_RESULT_CODE_OK) {
+                    std::this_thread::yield();
+                }
+                random_delay(rng);
+            }
+        });
+    }
+    for (size_t c = 0; c < cfg->num_consumers; c++) {
+        consumed[c].reserve(total);
+        threads.emplace_back([&, c]() {
+            std::minstd_rand rng(cfg->seed + 1000 + (uint32_t)c);
+            std::vector<StressElem> elems(cfg->capacity);
+            while (num_consumed.load() < total) {
+                size_t num_popped = 0;
+                if (ops->pop(&ctx, elems.data(), elems.size(), &num_popped) != RING_BUF_RESULT_CODE_OK) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                consumed[c].insert(consumed[c].end(), elems.begin(), elems.begin() + num_popped);
+                num_consumed += num_popped;
+                random_delay(rng);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    /* No loss, no duplication */
+    CHECK_EQUAL(total, num_consumed.load());
+    std::vector<std::vector<uint8_t>> seen(cfg->num_producers, std::vector<uint8_t>(cfg->elems_per_producer, 0));
+    for (const std::vector<StressElem> &elems : consumed) {
+        std::vector<int64_t> last_seq(cfg->num_producers, -1);
+        for (const StressElem &elem : elems) {
+            CHECK(elem.producer < cfg->num_producers);
+            CHECK(elem.seq < cfg->elems_per_producer);
+            CHECK_EQUAL(0, seen[elem.producer][elem.seq]);
+            seen[elem.producer][elem.seq] = 1;
+
+            /* Per-producer FIFO as observed by this consumer */
+            CHECK((int64_t)elem.seq > last_seq[elem.producer]);
+            last_seq[elem.producer] = elem.seq;
+        }
+    }
+    for (const std::vector<uint8_t> &producer_seen : seen) {
+        for (uint8_t s : producer_seen) {
+            CHECK_EQUAL(1, s);
+        }
+    }
+}
+
+static StressCfg make_stress_cfg(size_t num_producers, size_t num_consumers, size_t capacity, uint32_t seed)
+{
+    StressCfg cfg;
+    cfg.num_producers = num_producers;
+    cfg.num_consumers = num_consumers;
+    cfg.elems_per_producer = 20000;
+    cfg.capacity = capacity;
+    cfg.seed = seed;
+    return cfg;
+}
+
+// clang-format off
+TEST_GROUP(RingBufStress){
+    void setup() {
+        /* CppUTest leak detection is not thread-safe */
+        MemoryLeakWarningPlugin::saveAndDisableNewDeleteOverloads();
+        memset(&inst_buf, 0, sizeof(struct RingBufStruct));
+    }
+
+    void teardown() {
+        MemoryLeakWarningPlugin::restoreNewDeleteOverloads();
+    }
+};
+// clang-format on
+
+TEST(RingBufStress, SingleProducerSingleConsumer)
+{
+    StressCfg cfg = make_stress_cfg(1, 1, 16, 1);
+    run_stress(&cfg, &locked_pop_ops);
+}
+
+TEST(RingBufStress, ManyProducersManyConsumers)
+{
+    StressCfg cfg = make_stress_cfg(4, 4, 64, 2);
+    run_stress(&cfg, &locked_pop_ops);
+}
+
+TEST(RingBufStress, ManyProducersManyConsumersCapacityOne)
+{
+    StressCfg cfg = make_stress_cfg(4, 4, 1, 3);
+    run_stress(&cfg, &locked_pop_ops);
+}
+
+TEST(RingBufStress, ManyProducersDrainingConsumers)
+{
+    StressCfg cfg = make_stress_cfg(4, 2, 64, 4);
+    run_stress(&cfg, &locked_drain_ops);
+}